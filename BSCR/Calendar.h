@@ -0,0 +1,296 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+#include "Date.h"
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#endif
+
+namespace HKUltra {
+
+    // Business-day conventions, adjusting dates that are not business days
+    enum class BusinessDayConvention {
+        Unadjusted,         // Keep the date
+        Following,          // Next business day
+        ModifiedFollowing,  // Next business day, unless it is in the next month: then previous business day
+        Preceding,          // Previous business day
+        ModifiedPreceding   // Previous business day, unless it is in the previous month: then next business day
+    };
+
+    /*
+    * Calendar is a business-day calendar over a window of dates [first, last].
+    * It holds one bit per day, indexed by serial number, set for business days: weekends and holidays are clear.
+    * isBusinessDay is a single bit test; advance and businessDaysBetween count 64 days at a time with popcount,
+    * and find the final day within a word with a bit select (pdep with BMI2 on x64).
+    * The bitmap starts on a serial number multiple of 64, so calendars are joined with word-wide bitwise operations.
+    * Each state of the business days is stamped with a revision, unique across all calendars, which caches key on.
+    * Like Date, a Calendar is not synchronized: it can be read concurrently once built.
+    */
+    class Calendar {
+    public:
+        typedef Date::SerialType SerialType;  // Alias for the serial number type of the dates
+
+        /*
+        * Creates a calendar over [first, last] where every day is a business day except the weekend days.
+        */
+        Calendar(const Date& first, const Date& last,
+            std::initializer_list<std::chrono::weekday> weekend = { std::chrono::Saturday, std::chrono::Sunday })
+            : first_(first.serialNumber()), last_(last.serialNumber()), base_(alignedBase(first.serialNumber())), revision_(nextRevision()) {
+            if (last_ < first_) {
+                throw std::invalid_argument("Calendar window must not be empty.");
+            }
+            words_.assign(std::size_t(last_ - base_) / 64 + 1, 0);
+            for (SerialType serial_number = first_; serial_number <= last_; ++serial_number) {
+                const std::chrono::weekday weekday{ std::chrono::sys_days(Days(serial_number)) };
+                if (std::find(weekend.begin(), weekend.end(), weekday) == weekend.end()) {
+                    setBit(serial_number);
+                }
+            }
+        }
+
+        // First date of the calendar window
+        Date first() const {
+            return Date(first_);
+        }
+
+        // Last date of the calendar window
+        Date last() const {
+            return Date(last_);
+        }
+
+        /*
+        * Returns the revision of the business days: a number that no other calendar, nor this one after a change
+        * by addHoliday or removeHoliday, ever returns. Only copies share it, until either of them is changed.
+        * Two calendars with the same revision therefore have the same business days.
+        */
+        std::uint64_t revision() const {
+            return revision_;
+        }
+
+        // Marks a date as a holiday
+        void addHoliday(const Date& date) {
+            const std::size_t index = indexOf(date.serialNumber());
+            words_[index / 64] &= ~(std::uint64_t(1) << (index % 64));
+            revision_ = nextRevision();
+        }
+
+        // Marks a date as a business day, for instance a weekend day worked in exchange for a holiday
+        void removeHoliday(const Date& date) {
+            setBit(date.serialNumber());
+            revision_ = nextRevision();
+        }
+
+        // Returns true if the date is a business day, with a single bit test
+        bool isBusinessDay(const Date& date) const {
+            const std::size_t index = indexOf(date.serialNumber());
+            return (words_[index / 64] >> (index % 64)) & 1;
+        }
+
+        // Returns true if the date is a weekend day or a holiday
+        bool isHoliday(const Date& date) const {
+            return !isBusinessDay(date);
+        }
+
+        /*
+        * Returns the date `business_days` business days after a date (before it if negative),
+        * or the date itself if `business_days` is zero.
+        * Throws std::out_of_range if the result falls outside the calendar window.
+        */
+        Date advance(const Date& date, std::int32_t business_days) const {
+            const std::size_t index = indexOf(date.serialNumber());
+            if (business_days > 0) {
+                std::uint32_t remaining = std::uint32_t(business_days);
+                std::size_t word_index = (index + 1) / 64;
+                // Ignore the date itself and the days before it
+                std::uint64_t word = word_index < words_.size() ? words_[word_index] & (~std::uint64_t(0) << ((index + 1) % 64)) : 0;
+                while (word_index < words_.size()) {
+                    const std::uint32_t count = std::uint32_t(std::popcount(word));
+                    if (count >= remaining) {
+                        return dateAt(word_index * 64 + selectBit(word, remaining - 1));
+                    }
+                    remaining -= count;
+                    if (++word_index < words_.size()) {
+                        word = words_[word_index];
+                    }
+                }
+            }
+            else if (business_days < 0) {
+                std::uint32_t remaining = std::uint32_t(-std::int64_t(business_days));
+                std::size_t word_index = index / 64;
+                // Ignore the date itself and the days after it
+                std::uint64_t word = words_[word_index] & ((std::uint64_t(1) << (index % 64)) - 1);
+                while (true) {
+                    const std::uint32_t count = std::uint32_t(std::popcount(word));
+                    if (count >= remaining) {
+                        return dateAt(word_index * 64 + selectBit(word, count - remaining));
+                    }
+                    remaining -= count;
+                    if (word_index-- == 0) {
+                        break;
+                    }
+                    word = words_[word_index];
+                }
+            }
+            else {
+                return date;
+            }
+            throw std::out_of_range("Business day outside the calendar window.");
+        }
+
+        /*
+        * Adjusts a date that is not a business day according to a business-day convention.
+        * Throws std::out_of_range if the adjusted date falls outside the calendar window.
+        */
+        Date adjust(const Date& date, BusinessDayConvention convention) const {
+            if (convention == BusinessDayConvention::Unadjusted || isBusinessDay(date)) {
+                return date;
+            }
+            if (convention == BusinessDayConvention::Following || convention == BusinessDayConvention::ModifiedFollowing) {
+                const Date following = advance(date, 1);
+                if (convention == BusinessDayConvention::ModifiedFollowing && following.month() != date.month()) {
+                    return advance(date, -1);
+                }
+                return following;
+            }
+            const Date preceding = advance(date, -1);
+            if (convention == BusinessDayConvention::ModifiedPreceding && preceding.month() != date.month()) {
+                return advance(date, 1);
+            }
+            return preceding;
+        }
+
+        /*
+        * Returns the number of business days in [from, to) if from <= to, and minus the number of business days
+        * in [to, from) otherwise. Both dates must be in the calendar window or be the day after its last date,
+        * which ends an interval covering the rest of the window.
+        */
+        std::int32_t businessDaysBetween(const Date& from, const Date& to) const {
+            if (to < from) {
+                return -businessDaysBetween(to, from);
+            }
+            const std::size_t begin = boundOf(from.serialNumber());
+            const std::size_t end = boundOf(to.serialNumber());
+            if (begin == end) {
+                return 0;
+            }
+            const std::size_t first_word = begin / 64;
+            const std::size_t last_word = end / 64;  // One past the last word when `to` follows a window ending on bit 63
+            const std::uint64_t begin_mask = ~std::uint64_t(0) << (begin % 64);  // Days from `from` in its word
+            const std::uint64_t end_mask = (std::uint64_t(1) << (end % 64)) - 1;  // Days before `to` in its word
+            if (first_word == last_word) {
+                return std::popcount(words_[first_word] & begin_mask & end_mask);
+            }
+            std::int32_t count = std::popcount(words_[first_word] & begin_mask);
+            for (std::size_t word_index = first_word + 1; word_index < last_word; ++word_index) {
+                count += std::popcount(words_[word_index]);
+            }
+            if (end_mask != 0) {  // Otherwise `to` starts its word, which may lie past the bitmap
+                count += std::popcount(words_[last_word] & end_mask);
+            }
+            return count;
+        }
+
+        /*
+        * Joins two calendars so that a day is a holiday if it is a holiday in either of them (bitwise and).
+        * The result covers the intersection of their windows.
+        */
+        friend Calendar joinHolidays(const Calendar& lhs, const Calendar& rhs) {
+            return Calendar(lhs, rhs, [](std::uint64_t a, std::uint64_t b) { return a & b; });
+        }
+
+        /*
+        * Joins two calendars so that a day is a business day if it is a business day in either of them (bitwise or).
+        * The result covers the intersection of their windows.
+        */
+        friend Calendar joinBusinessDays(const Calendar& lhs, const Calendar& rhs) {
+            return Calendar(lhs, rhs, [](std::uint64_t a, std::uint64_t b) { return a | b; });
+        }
+
+    private:
+        SerialType first_;  // Serial number of the first date of the window
+        SerialType last_;  // Serial number of the last date of the window
+        SerialType base_;  // Serial number of bit 0 of the first word, a multiple of 64
+        std::uint64_t revision_;  // Revision of the business days, see revision()
+        std::vector<std::uint64_t> words_;  // One bit per day from base_, set for business days within the window
+
+        // Combines the words of two calendars over the intersection of their windows
+        template <typename _operation>
+        Calendar(const Calendar& lhs, const Calendar& rhs, _operation operation)
+            : first_(std::max(lhs.first_, rhs.first_)), last_(std::min(lhs.last_, rhs.last_)), base_(alignedBase(first_)), revision_(nextRevision()) {
+            if (last_ < first_) {
+                throw std::invalid_argument("Calendar windows do not overlap.");
+            }
+            words_.resize(std::size_t(last_ - base_) / 64 + 1);
+            const std::size_t lhs_offset = std::size_t(base_ - lhs.base_) / 64;  // Both bases are multiples of 64
+            const std::size_t rhs_offset = std::size_t(base_ - rhs.base_) / 64;
+            for (std::size_t i = 0; i < words_.size(); ++i) {
+                words_[i] = operation(lhs.words_[lhs_offset + i], rhs.words_[rhs_offset + i]);
+            }
+            // Clear the days outside the window
+            words_.front() &= ~std::uint64_t(0) << std::size_t(first_ - base_);
+            const std::size_t last_bit = std::size_t(last_ - base_) % 64;
+            if (last_bit != 63) {
+                words_.back() &= (std::uint64_t(1) << (last_bit + 1)) - 1;
+            }
+        }
+
+        // Returns a revision never returned before, by any calendar
+        static std::uint64_t nextRevision() {
+            static std::atomic<std::uint64_t> revisions{ 0 };  // Calendars may be built on several threads
+            return revisions.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        // Rounds a serial number down to a multiple of 64
+        static SerialType alignedBase(SerialType serial_number) {
+            return serial_number & ~SerialType(63);
+        }
+
+        // Returns the bit index of a date. Throws std::out_of_range outside the window
+        std::size_t indexOf(SerialType serial_number) const {
+            if (serial_number < first_ || serial_number > last_) {
+                throw std::out_of_range("Date outside the calendar window.");
+            }
+            return std::size_t(serial_number - base_);
+        }
+
+        // Returns the bit index of a bound of a half-open interval, which may also be the day after the window
+        std::size_t boundOf(SerialType serial_number) const {
+            return serial_number == last_ + 1 ? std::size_t(serial_number - base_) : indexOf(serial_number);
+        }
+
+        // Returns the date of a bit index
+        Date dateAt(std::size_t index) const {
+            return Date(SerialType(base_ + SerialType(index)));
+        }
+
+        void setBit(SerialType serial_number) {
+            const std::size_t index = indexOf(serial_number);
+            words_[index / 64] |= std::uint64_t(1) << (index % 64);
+        }
+
+        // Returns the position of the set bit of rank `rank` (0 for the lowest set bit) in a word
+        static std::uint32_t selectBit(std::uint64_t word, std::uint32_t rank) {
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__)))
+            return std::uint32_t(std::countr_zero(_pdep_u64(std::uint64_t(1) << rank, word)));
+#else
+            for (; rank > 0; --rank) {
+                word &= word - 1;  // Clear the lowest set bit
+            }
+            return std::uint32_t(std::countr_zero(word));
+#endif
+        }
+    };
+
+} // namespace HKUltra
@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include "DependencyNode.h"
+#include "LockPolicy.h"
+#include "Observable.h"
+#include "ObservableValue.h"
+#include "ValueStorage.h"
+
+namespace HKUltra {
+
+    /*
+    * Computed is a value derived from ObservableValues and other Computed values by a function, e.g.
+    *   Computed<double> accrued([](const Date& date, double rate) { ... }, as_of_date, rate);
+    * It is itself observable, like ObservableValue: observers receive the new value and its version.
+    * A change of a source marks the value dirty. The value is computed on construction, then only when it is read
+    * while dirty, or once per propagation wave if it has observers (see DependencyNode). Since a wave refreshes nodes
+    * in rank order and each recomputation reads its sources' current values, observers never see a value computed
+    * from a mix of updated and stale sources, and a value reached through a diamond notifies once.
+    * A value is only cached while no source is being stored, so get() never returns a value older than its sources.
+    * The sources must outlive the Computed value. The function runs under the lock of the value: it must not read
+    * the value itself.
+    */
+    template <typename _type, typename _lock = std::mutex>
+    class Computed : public BasicObservable<_lock, _type, ValueVersion>, public BasicDependencyNode<_lock> {
+    public:
+        /*
+        * Creates a value computed as function(sources.get()...). Each source is an ObservableValue or a Computed
+        * value using the same lock policy.
+        */
+        template <typename _function, typename... _sources>
+        explicit Computed(_function function, _sources&... sources)
+            : function_([function, &sources...]() -> _type { return function(sources.get()...); }), value_(function_()) {
+            static_assert((std::is_base_of_v<BasicDependencyNode<_lock>, _sources> && ...),
+                "Computed sources must be ObservableValues or Computed values using the same lock policy as the Computed value.");
+            (this->dependOn(sources), ...);
+        }
+
+        // Returns the current value, recomputing it if a source changed since the last computation
+        _type get() const {
+            return getVersioned().value;
+        }
+
+        // Returns the current value together with its version, which increases each time the computed value changes
+        Versioned<_type> getVersioned() const {
+            WriteGuard<_lock> lock(mtx_);
+            const std::uint64_t epoch = epoch_.load();
+            if (computed_epoch_ != epoch) {
+                const bool changing = changing_.load() != 0;  // Read after the epoch: see invalidate
+                _type value = function_();  // Reads the sources, which refresh themselves first if they are dirty
+                if (value != value_) {
+                    value_ = std::move(value);
+                    ++version_;
+                }
+                if (!changing) {
+                    computed_epoch_ = epoch;  // Otherwise the value may miss a source being stored: stay dirty
+                }
+            }
+            return Versioned<_type>{ value_, version_ };
+        }
+
+        // Returns the version of the current value
+        ValueVersion version() const {
+            return getVersioned().version;
+        }
+
+    private:
+        std::function<_type()> function_;  // Computes the value from the current values of the sources
+        mutable _lock mtx_;  // Lock for thread safety of the cached value
+        mutable _type value_;  // Value computed last
+        mutable ValueVersion version_ = 1;  // Version of value_
+        mutable std::uint64_t computed_epoch_ = 1;  // Epoch value_ was computed at
+        std::atomic<std::uint64_t> epoch_{ 1 };  // Incremented before and after each change of a source
+        std::atomic<std::uint32_t> changing_{ 0 };  // Number of changes of sources being stored
+        std::atomic<ValueVersion> notified_version_{ 1 };  // Last version delivered to the observers
+
+        /*
+        * Called before a source is stored. changing_ is incremented before the epoch, so a read seeing the new epoch
+        * also sees the change in progress and does not cache the value it computes.
+        */
+        void invalidate() override {
+            changing_.fetch_add(1);
+            epoch_.fetch_add(1);
+        }
+
+        // Called once the source is stored: values computed before are computed again
+        void settle() override {
+            epoch_.fetch_add(1);
+            changing_.fetch_sub(1);
+        }
+
+        void refresh() override {
+            if (!this->hasObservers()) {
+                return;  // Stay dirty until read
+            }
+            const Versioned<_type> current = getVersioned();
+            ValueVersion notified = notified_version_.load(std::memory_order_relaxed);
+            while (current.version > notified) {
+                if (notified_version_.compare_exchange_weak(notified, current.version)) {
+                    this->notifyObservers(current.value, current.version);
+                    return;
+                }
+            }
+        }
+    };
+
+} // namespace HKUltra
@@ -1,7 +1,12 @@
 #pragma once
 #include <chrono>
-#include <exception>
-#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include "DateConversion.h"
+#include "DateLookup.h"
 namespace HKUltra {
 
     // Typedefs for convenience to use chrono types for dates
@@ -15,106 +20,283 @@ namespace HKUltra {
     typedef std::chrono::days Days;     // Represents a duration of days
 
     // Date class represents a specific date and provides utilities for date manipulation
+    // It only stores the serial number of the date: it is 4 bytes, trivially copyable and lock-free,
+    // and the year, month and day are computed on demand
+    // All its operations are constexpr, so dates can be built and shifted at compile time
     class Date {
     public:
-        // SerialType is a long integer used to represent the date in serial format
-        typedef long SerialType;
+        // SerialType is a 32-bit integer used to represent the date in serial format (days since 1970-01-01)
+        typedef std::int32_t SerialType;
 
         // Default constructor: Initializes a date object with a default value (typically the epoch date)
-        Date();
+        constexpr Date();
 
         // Constructor: Initializes a date with a specific year, month, and day
-        Date(Year year, Month month, Day day);
+        constexpr Date(Year year, Month month, Day day);
 
-        //Copy constructor (required due to mutex)
-        Date(const Date& date);
-        Date& operator=(const Date& rhs);
+        // Constructor: Initializes a date from its serial number
+        explicit constexpr Date(SerialType serial_number);
 
-        // Destructor: Default destructor, no special cleanup needed
+        // Copy constructor, assignment and destructor are trivial, so dates can be copied with memcpy
+        Date(const Date& date) = default;
+        Date& operator=(const Date& rhs) = default;
         ~Date() = default;
 
         // Accessor for the day component of the date
-        Day day() const;
+        constexpr Day day() const;
 
         // Accessor for the month component of the date
-        Month month() const;
+        constexpr Month month() const;
 
         // Accessor for the year component of the date
-        Year year() const;
+        constexpr Year year() const;
 
         // Accessor for the serial number representing the date (useful for calculations, comparisons, etc.)
-        SerialType serialNumber() const;
+        constexpr SerialType serialNumber() const;
 
         // Mathematical operators for manipulating dates by adding or subtracting durations of years, months, or days
 
         // Add a duration of years to the current date
-        Date& operator+=(const Years& years);
+        constexpr Date& operator+=(const Years& years);
 
         // Subtract a duration of years from the current date
-        Date& operator-=(const Years& years);
+        constexpr Date& operator-=(const Years& years);
 
         // Add a duration of months to the current date
-        Date& operator+=(const Months& months);
+        constexpr Date& operator+=(const Months& months);
 
         // Subtract a duration of months from the current date
-        Date& operator-=(const Months& months);
+        constexpr Date& operator-=(const Months& months);
 
         // Add a duration of days to the current date
-        Date& operator+=(const Days& days);
+        constexpr Date& operator+=(const Days& days);
 
         // Subtract a duration of days from the current date
-        Date& operator-=(const Days& days);
+        constexpr Date& operator-=(const Days& days);
 
         // Create a new date by adding a duration of years to the current date
-        Date operator+(const Years& years) const;
+        constexpr Date operator+(const Years& years) const;
 
         // Create a new date by subtracting a duration of years from the current date
-        Date operator-(const Years& years) const;
+        constexpr Date operator-(const Years& years) const;
 
         // Create a new date by adding a duration of months to the current date
-        Date operator+(const Months& months) const;
+        constexpr Date operator+(const Months& months) const;
 
         // Create a new date by subtracting a duration of months from the current date
-        Date operator-(const Months& months) const;
+        constexpr Date operator-(const Months& months) const;
 
         // Create a new date by adding a duration of days to the current date
-        Date operator+(const Days& days) const;
+        constexpr Date operator+(const Days& days) const;
 
         // Create a new date by subtracting a duration of days from the current date
-        Date operator-(const Days& days) const;
+        constexpr Date operator-(const Days& days) const;
 
         // Logic operators to compare dates
 
         // Check if the current date is equal to another date
-        bool operator==(const Date& rhs) const;
+        constexpr bool operator==(const Date& rhs) const;
 
         // Check if the current date is greater than another date
-        bool operator>(const Date& rhs) const;
+        constexpr bool operator>(const Date& rhs) const;
 
         // Check if the current date is less than another date
-        bool operator<(const Date& rhs) const;
+        constexpr bool operator<(const Date& rhs) const;
 
         // Check if the current date is greater than or equal to another date
-        bool operator>=(const Date& rhs) const;
+        constexpr bool operator>=(const Date& rhs) const;
 
         // Check if the current date is less than or equal to another date
-        bool operator<=(const Date& rhs) const;
+        constexpr bool operator<=(const Date& rhs) const;
 
     private:
-        // Mutex for thread safety
-        mutable std::mutex mtx_;
+        // Serial number for the date, the only state of the date
+        SerialType serial_number_;
 
-        // Internal representation of the date using chrono's year_month_day type
-        std::chrono::year_month_day year_month_day_;
+        // Computes the year, month and day of the date from its serial number
+        constexpr std::chrono::year_month_day yearMonthDay() const;
 
-        // Serial number for the date, used for quick comparison and calculations
-        Date::SerialType serial_number_;
-
-        // Resets the serial number when the date changes
-        void resetSerial();
-
-        // Static helper method to calculate the last day of a given month
-        static Day lastDayOfMonth(std::chrono::year_month_day year_month_day);
+        // Computes the serial number of a year, month and day
+        static constexpr SerialType toSerialNumber(std::chrono::year_month_day year_month_day);
     };
 
+    static_assert(sizeof(Date) == sizeof(Date::SerialType), "Date must only hold its serial number.");
+    static_assert(std::is_trivially_copyable_v<Date>, "Date must be trivially copyable.");
+
+    // Default constructor: Initializes Date to January 1, 1900
+    constexpr Date::Date() : serial_number_(toSerialNumber(Year(1900) / Month(1) / Day(1))) {}  // Set to the default date: 1st Jan 1900
+
+    // Constructor with Year, Month, and Day as inputs
+    constexpr Date::Date(Year year, Month month, Day day) {
+        std::chrono::year_month_day year_month_day = { year / month / day };  // Construct the date with the provided values
+        if (!year_month_day.ok()) {  // Check if the date is valid
+            throw std::invalid_argument("Invalid date.");  // Throw an exception if the date is invalid; fails compilation in constant expressions
+        }
+        serial_number_ = toSerialNumber(year_month_day);  // Store the serial number of the date
+    }
+
+    // Constructor from a serial number
+    constexpr Date::Date(SerialType serial_number) : serial_number_(serial_number) {}
+
+    // Getter for the year component of the date
+    constexpr Year Date::year() const {
+        return yearMonthDay().year();  // Return the year
+    }
+
+    // Getter for the month component of the date
+    constexpr Month Date::month() const {
+        return yearMonthDay().month();  // Return the month
+    }
+
+    // Getter for the day component of the date
+    constexpr Day Date::day() const {
+        return yearMonthDay().day();  // Return the day
+    }
+
+    // Getter for the serial number associated with the date
+    constexpr Date::SerialType Date::serialNumber() const {
+        return serial_number_;  // Return the serial number
+    }
+
+    // Addition operator (+=) for years, updates the date by adding the given years
+    constexpr Date& Date::operator+=(const Years& years) {
+        // Month arithmetic clamped to the end of the month, looked up in the tables of DateLookup.h
+        serial_number_ = DateLookup::addMonths(serial_number_, static_cast<std::int32_t>(12 * years.count()));
+        return *this;
+    }
+
+    // Subtraction operator (-=) for years, updates the date by subtracting the given years
+    constexpr Date& Date::operator-=(const Years& years) {
+        serial_number_ = DateLookup::addMonths(serial_number_, -static_cast<std::int32_t>(12 * years.count()));
+        return *this;
+    }
+
+    // Similar operators for Months and Days (+=, -=) to modify the date by adding or subtracting months or days
+    constexpr Date& Date::operator+=(const Months& months) {
+        serial_number_ = DateLookup::addMonths(serial_number_, static_cast<std::int32_t>(months.count()));
+        return *this;
+    }
+
+    constexpr Date& Date::operator-=(const Months& months) {
+        serial_number_ = DateLookup::addMonths(serial_number_, -static_cast<std::int32_t>(months.count()));
+        return *this;
+    }
+
+    constexpr Date& Date::operator+=(const Days& days) {
+        serial_number_ += static_cast<SerialType>(days.count());  // Add days to the serial number
+        return *this;
+    }
+
+    constexpr Date& Date::operator-=(const Days& days) {
+        serial_number_ -= static_cast<SerialType>(days.count());  // Subtract days from the serial number
+        return *this;
+    }
+
+    // Other operators: + and - for adding or subtracting years, months, or days
+    constexpr Date Date::operator+(const Years& years) const {
+        Date date = *this;
+        date += years;  // Modify the date by adding years
+        return date;  // Return the modified date
+    }
+
+    constexpr Date Date::operator-(const Years& years) const {
+        Date date = *this;
+        date -= years;  // Modify the date by subtracting years
+        return date;  // Return the modified date
+    }
+
+    // Similar operators for Months and Days
+    constexpr Date Date::operator+(const Months& months) const {
+        Date date = *this;
+        date += months;  // Modify the date by adding months
+        return date;  // Return the modified date
+    }
+
+    constexpr Date Date::operator-(const Months& months) const {
+        Date date = *this;
+        date -= months;  // Modify the date by subtracting months
+        return date;  // Return the modified date
+    }
+
+    constexpr Date Date::operator+(const Days& days) const {
+        Date date = *this;
+        date += days;  // Modify the date by adding days
+        return date;  // Return the modified date
+    }
+
+    constexpr Date Date::operator-(const Days& days) const {
+        Date date = *this;
+        date -= days;  // Modify the date by subtracting days
+        return date;  // Return the modified date
+    }
+
+    // Comparison operators
+    constexpr bool Date::operator==(const Date& rhs) const {
+        return serial_number_ == rhs.serial_number_;  // Compare the serial numbers for equality
+    }
+
+    constexpr bool Date::operator>(const Date& rhs) const {
+        return serial_number_ > rhs.serial_number_;  // Compare the serial numbers
+    }
+
+    constexpr bool Date::operator<(const Date& rhs) const {
+        return serial_number_ < rhs.serial_number_;  // Compare the serial numbers
+    }
+
+    constexpr bool Date::operator>=(const Date& rhs) const {
+        return serial_number_ >= rhs.serial_number_;  // Compare the serial numbers
+    }
+
+    constexpr bool Date::operator<=(const Date& rhs) const {
+        return serial_number_ <= rhs.serial_number_;  // Compare the serial numbers
+    }
+
+    // Computes the year, month and day from the serial number
+    constexpr std::chrono::year_month_day Date::yearMonthDay() const {
+        const CivilDate date = DateLookup::civil(serial_number_);  // Table lookup, see DateLookup.h
+        return std::chrono::year_month_day{ Year(date.year), Month(date.month), Day(date.day) };
+    }
+
+    // Computes the serial number of the given year, month and day
+    constexpr Date::SerialType Date::toSerialNumber(std::chrono::year_month_day year_month_day) {
+        return serialFromCivil(int(year_month_day.year()), unsigned(year_month_day.month()), unsigned(year_month_day.day()));  // Compute the serial number
+    }
+
+    inline namespace literals {
+
+        /*
+        * Date literal in the ISO-8601 format YYYY-MM-DD, e.g. "2023-01-01"_date.
+        * It is evaluated at compile time: a malformed or invalid date fails compilation.
+        */
+        consteval Date operator""_date(const char* text, std::size_t length) {
+            if (length != 10 || text[4] != '-' || text[7] != '-') {
+                throw std::invalid_argument("Date literals must be formatted as YYYY-MM-DD.");
+            }
+            int fields[3] = { 0, 0, 0 };  // Year, month and day
+            const std::size_t starts[3] = { 0, 5, 8 };
+            const std::size_t ends[3] = { 4, 7, 10 };
+            for (int field = 0; field < 3; ++field) {
+                for (std::size_t i = starts[field]; i < ends[field]; ++i) {
+                    if (text[i] < '0' || text[i] > '9') {
+                        throw std::invalid_argument("Date literals must be formatted as YYYY-MM-DD.");
+                    }
+                    fields[field] = fields[field] * 10 + (text[i] - '0');
+                }
+            }
+            return Date(Year(fields[0]), Month(unsigned(fields[1])), Day(unsigned(fields[2])));  // Throws on invalid dates such as 2023-02-29
+        }
+
+    } // namespace literals
+
 } // namespace HKUltra
+
+/*
+* std::hash support, so dates can key unordered containers. The hash is the hash of the serial number:
+* consecutive dates land in consecutive buckets.
+*/
+template <>
+struct std::hash<HKUltra::Date> {
+    std::size_t operator()(const HKUltra::Date& date) const noexcept {
+        return std::hash<HKUltra::Date::SerialType>()(date.serialNumber());
+    }
+};
@@ -0,0 +1,228 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+
+// The batch conversions use AVX2, or SSE4.1 (implied by AVX), when the compiler targets them. MSVC never defines
+// __SSE4_1__ and only defines __AVX2__ under /arch:AVX2 (EnableEnhancedInstructionSet), which the x64 configurations
+// of the projects set, so their binaries require AVX2 hardware; the Win32 configurations keep the default, and every
+// vectorized path of the library falls back to its scalar loop there.
+#if defined(__AVX2__) || defined(__SSE4_1__) || defined(__AVX__)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#endif
+
+namespace HKUltra {
+
+    /*
+    * Conversions between serial numbers (days since 1970-01-01) and civil dates (year, month, day)
+    * in the proleptic Gregorian calendar, based on the Euclidean affine functions of Neri and Schneider.
+    * The computations are done on unsigned 32-bit integers, shifted by a whole number of 400-year cycles so that
+    * they never go negative; divisions are by constants, so they compile to multiplications and shifts.
+    * The batch functions convert spans of dates with AVX2 (8 dates at a time) or SSE4.1 (4 dates at a time)
+    * when the target supports them, and fall back to the scalar kernel otherwise.
+    * Results are exact for years -32767 to 32767, the range of std::chrono::year.
+    */
+
+    // CivilDate holds the year, month (1 to 12) and day (1 to 31) of a date
+    struct CivilDate {
+        std::int32_t year;
+        std::uint32_t month;
+        std::uint32_t day;
+    };
+
+    namespace DateConversion {
+
+        constexpr std::uint32_t cycles = 82;  // Number of 400-year cycles the computations are shifted by
+        constexpr std::uint32_t year_shift = 400 * cycles;  // Shift applied to years
+        constexpr std::uint32_t day_shift = 719468 + 146097 * cycles;  // Shift applied to serial numbers, 719468 being 1970-01-01 counted from 0000-03-01
+
+    } // namespace DateConversion
+
+    // Converts a serial number into a civil date
+    constexpr CivilDate civilFromSerial(std::int32_t serial_number) {
+        using namespace DateConversion;
+        // Century and day of the century, in a calendar starting on March 1st
+        const std::uint32_t n = std::uint32_t(serial_number) + day_shift;
+        const std::uint32_t n_1 = 4 * n + 3;
+        const std::uint32_t century = n_1 / 146097;
+        const std::uint32_t n_c = n_1 % 146097 / 4;
+        // Year of the century and day of the year
+        const std::uint32_t n_2 = 4 * n_c + 3;
+        const std::uint32_t year_of_century = n_2 / 1461;
+        const std::uint32_t n_y = n_2 % 1461 / 4;
+        // Month and day, March being month 3 and February month 14
+        const std::uint32_t n_3 = 2141 * n_y + 197913;
+        const std::uint32_t month = n_3 / 65536;
+        const std::uint32_t day = n_3 % 65536 / 2141;
+        // Map back to the Gregorian calendar, where January and February belong to the next year
+        const std::uint32_t january_or_february = n_y >= 306;
+        return CivilDate{
+            std::int32_t(100 * century + year_of_century + january_or_february) - std::int32_t(year_shift),
+            january_or_february ? month - 12 : month,
+            day + 1 };
+    }
+
+    // Converts a civil date into a serial number
+    constexpr std::int32_t serialFromCivil(std::int32_t year, std::uint32_t month, std::uint32_t day) {
+        using namespace DateConversion;
+        // Shift to a calendar starting on March 1st, where January and February belong to the previous year
+        const std::uint32_t january_or_february = month <= 2;
+        const std::uint32_t y = std::uint32_t(year + std::int32_t(year_shift)) - january_or_february;
+        const std::uint32_t m = january_or_february ? month + 12 : month;
+        const std::uint32_t century = y / 100;
+        // Days before the year, plus days before the month, plus days before the day
+        const std::uint32_t days_of_years = 1461 * y / 4 - century + century / 4;
+        const std::uint32_t days_of_months = (979 * m - 2919) / 32;
+        return std::int32_t(days_of_years + days_of_months + day - 1 - day_shift);
+    }
+
+    // Converts a civil date into a serial number
+    constexpr std::int32_t serialFromCivil(const CivilDate& date) {
+        return serialFromCivil(date.year, date.month, date.day);
+    }
+
+    namespace DateConversion {
+
+#if defined(__AVX2__)
+        typedef __m256i VectorType;  // 8 dates at a time
+        constexpr std::size_t lanes = 8;
+
+        inline VectorType load(const void* source) { return _mm256_loadu_si256(static_cast<const __m256i*>(source)); }
+        inline void store(void* destination, VectorType value) { _mm256_storeu_si256(static_cast<__m256i*>(destination), value); }
+        inline VectorType broadcast(std::uint32_t value) { return _mm256_set1_epi32(int(value)); }
+        inline VectorType add(VectorType a, VectorType b) { return _mm256_add_epi32(a, b); }
+        inline VectorType subtract(VectorType a, VectorType b) { return _mm256_sub_epi32(a, b); }
+        inline VectorType multiply(VectorType a, VectorType b) { return _mm256_mullo_epi32(a, b); }
+        inline VectorType bitAnd(VectorType a, VectorType b) { return _mm256_and_si256(a, b); }
+        inline VectorType bitXor(VectorType a, VectorType b) { return _mm256_xor_si256(a, b); }
+        inline VectorType greaterThan(VectorType a, VectorType b) { return _mm256_cmpgt_epi32(a, b); }  // All ones where a > b
+        inline VectorType equal(VectorType a, VectorType b) { return _mm256_cmpeq_epi32(a, b); }  // All ones where a == b
+        inline VectorType minimum(VectorType a, VectorType b) { return _mm256_min_epu32(a, b); }
+        template <int _shift> VectorType shiftRight(VectorType a) { return _mm256_srli_epi32(a, _shift); }
+
+        // Computes x * magic >> _shift for each lane, with a 64-bit intermediate product
+        template <int _shift>
+        VectorType multiplyHigh(VectorType x, VectorType magic) {
+            const __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(x, magic), _shift);
+            const __m256i odd = _mm256_slli_epi64(_mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), magic), _shift), 32);
+            return _mm256_blend_epi32(even, odd, 0xAA);
+        }
+#elif defined(__SSE4_1__) || defined(__AVX__)
+        typedef __m128i VectorType;  // 4 dates at a time
+        constexpr std::size_t lanes = 4;
+
+        inline VectorType load(const void* source) { return _mm_loadu_si128(static_cast<const __m128i*>(source)); }
+        inline void store(void* destination, VectorType value) { _mm_storeu_si128(static_cast<__m128i*>(destination), value); }
+        inline VectorType broadcast(std::uint32_t value) { return _mm_set1_epi32(int(value)); }
+        inline VectorType add(VectorType a, VectorType b) { return _mm_add_epi32(a, b); }
+        inline VectorType subtract(VectorType a, VectorType b) { return _mm_sub_epi32(a, b); }
+        inline VectorType multiply(VectorType a, VectorType b) { return _mm_mullo_epi32(a, b); }
+        inline VectorType bitAnd(VectorType a, VectorType b) { return _mm_and_si128(a, b); }
+        inline VectorType bitXor(VectorType a, VectorType b) { return _mm_xor_si128(a, b); }
+        inline VectorType greaterThan(VectorType a, VectorType b) { return _mm_cmpgt_epi32(a, b); }  // All ones where a > b
+        inline VectorType equal(VectorType a, VectorType b) { return _mm_cmpeq_epi32(a, b); }  // All ones where a == b
+        inline VectorType minimum(VectorType a, VectorType b) { return _mm_min_epu32(a, b); }
+        template <int _shift> VectorType shiftRight(VectorType a) { return _mm_srli_epi32(a, _shift); }
+
+        // Computes x * magic >> _shift for each lane, with a 64-bit intermediate product
+        template <int _shift>
+        VectorType multiplyHigh(VectorType x, VectorType magic) {
+            const __m128i even = _mm_srli_epi64(_mm_mul_epu32(x, magic), _shift);
+            const __m128i odd = _mm_slli_epi64(_mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(x, 32), magic), _shift), 32);
+            return _mm_blend_epi16(even, odd, 0xCC);
+        }
+#else
+        constexpr std::size_t lanes = 0;  // No vector instructions: the batch functions use the scalar kernel
+#endif
+
+#if defined(__AVX2__) || defined(__SSE4_1__) || defined(__AVX__)
+        /*
+        * Vector version of civilFromSerial. Divisions by constants are done as multiplications by
+        * magic numbers m = ceil(2^s / d), exact for the numerators reached by dates of years -32767 to 32767.
+        */
+        inline void civilFromSerial(VectorType serial_number, VectorType& year, VectorType& month, VectorType& day) {
+            const VectorType n = add(serial_number, broadcast(day_shift));
+            const VectorType n_1 = add(multiply(n, broadcast(4)), broadcast(3));  // Below 2^27
+            const VectorType century = multiplyHigh<45>(n_1, broadcast(240828848));  // n_1 / 146097
+            const VectorType n_c = shiftRight<2>(subtract(n_1, multiply(century, broadcast(146097))));
+            const VectorType n_2 = add(multiply(n_c, broadcast(4)), broadcast(3));  // Below 2^20
+            const VectorType year_of_century = multiplyHigh<31>(n_2, broadcast(1469873));  // n_2 / 1461
+            const VectorType n_y = shiftRight<2>(subtract(n_2, multiply(year_of_century, broadcast(1461))));
+            const VectorType n_3 = add(multiply(n_y, broadcast(2141)), broadcast(197913));
+            const VectorType m = shiftRight<16>(n_3);
+            const VectorType d = multiplyHigh<28>(bitAnd(n_3, broadcast(0xFFFF)), broadcast(125379));  // (n_3 % 65536) / 2141
+            const VectorType january_or_february = greaterThan(n_y, broadcast(305));  // All ones for January and February
+            year = subtract(subtract(add(multiply(century, broadcast(100)), year_of_century), broadcast(year_shift)), january_or_february);
+            month = subtract(m, bitAnd(january_or_february, broadcast(12)));
+            day = add(d, broadcast(1));
+        }
+
+        // Vector version of serialFromCivil
+        inline VectorType serialFromCivil(VectorType year, VectorType month, VectorType day) {
+            const VectorType january_or_february = greaterThan(broadcast(3), month);  // All ones for January and February
+            const VectorType y = add(add(year, broadcast(year_shift)), january_or_february);  // Below 2^17
+            const VectorType m = add(month, bitAnd(january_or_february, broadcast(12)));
+            const VectorType century = multiplyHigh<24>(y, broadcast(167773));  // y / 100
+            const VectorType days_of_years = add(subtract(shiftRight<2>(multiply(y, broadcast(1461))), century), shiftRight<2>(century));
+            const VectorType days_of_months = shiftRight<5>(subtract(multiply(m, broadcast(979)), broadcast(2919)));
+            return subtract(add(add(days_of_years, days_of_months), day), broadcast(day_shift + 1));
+        }
+#endif
+
+    } // namespace DateConversion
+
+    /*
+    * Converts a span of serial numbers into the years, months and days spans, which must have the same size.
+    */
+    inline void civilFromSerials(std::span<const std::int32_t> serial_numbers,
+        std::span<std::int32_t> years, std::span<std::uint32_t> months, std::span<std::uint32_t> days) {
+        const std::size_t size = serial_numbers.size();
+        if (years.size() != size || months.size() != size || days.size() != size) {
+            throw std::invalid_argument("Date spans must have the same size.");
+        }
+        std::size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE4_1__) || defined(__AVX__)
+        for (; i + DateConversion::lanes <= size; i += DateConversion::lanes) {
+            DateConversion::VectorType year, month, day;
+            DateConversion::civilFromSerial(DateConversion::load(&serial_numbers[i]), year, month, day);
+            DateConversion::store(&years[i], year);
+            DateConversion::store(&months[i], month);
+            DateConversion::store(&days[i], day);
+        }
+#endif
+        for (; i < size; ++i) {  // Remaining dates
+            const CivilDate date = civilFromSerial(serial_numbers[i]);
+            years[i] = date.year;
+            months[i] = date.month;
+            days[i] = date.day;
+        }
+    }
+
+    /*
+    * Converts the years, months and days spans into a span of serial numbers, which must all have the same size.
+    * The civil dates must be valid.
+    */
+    inline void serialsFromCivil(std::span<const std::int32_t> years, std::span<const std::uint32_t> months,
+        std::span<const std::uint32_t> days, std::span<std::int32_t> serial_numbers) {
+        const std::size_t size = serial_numbers.size();
+        if (years.size() != size || months.size() != size || days.size() != size) {
+            throw std::invalid_argument("Date spans must have the same size.");
+        }
+        std::size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE4_1__) || defined(__AVX__)
+        for (; i + DateConversion::lanes <= size; i += DateConversion::lanes) {
+            DateConversion::store(&serial_numbers[i], DateConversion::serialFromCivil(
+                DateConversion::load(&years[i]), DateConversion::load(&months[i]), DateConversion::load(&days[i])));
+        }
+#endif
+        for (; i < size; ++i) {  // Remaining dates
+            serial_numbers[i] = serialFromCivil(years[i], months[i], days[i]);
+        }
+    }
+
+} // namespace HKUltra
@@ -0,0 +1,141 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <version>
+#include "Date.h"
+#include "DateConversion.h"
+#include "DateParser.h"
+#include "DateVector.h"
+
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
+namespace HKUltra {
+
+    namespace DateFormatting {
+
+        // Table of the 100 two-digit strings "00" to "99", so each pair of digits is written with a single copy
+        struct DigitPairs {
+            char characters[200];
+
+            constexpr DigitPairs() : characters() {
+                for (int i = 0; i < 100; ++i) {
+                    characters[2 * i] = char('0' + i / 10);
+                    characters[2 * i + 1] = char('0' + i % 10);
+                }
+            }
+        };
+
+        inline constexpr DigitPairs digit_pairs;
+
+        // Writes the two digits of a value below 100
+        constexpr char* writePair(char* buffer, std::uint32_t value) {
+            buffer[0] = digit_pairs.characters[2 * value];
+            buffer[1] = digit_pairs.characters[2 * value + 1];
+            return buffer + 2;
+        }
+
+        // Largest year the formats can represent in their four digits
+        constexpr std::uint32_t max_year = 9999;
+
+        /*
+        * Writes the fields of a date, in `DateParsing::width(format)` characters.
+        * Throws std::out_of_range if the year is not between 0 and max_year.
+        */
+        constexpr char* writeFields(char* buffer, const CivilDate& date, DateFormat format) {
+            const std::uint32_t year = std::uint32_t(date.year);  // Negative years wrap around above max_year
+            if (year > max_year) {
+                throw std::out_of_range("Only dates of years 0 to 9999 can be formatted.");
+            }
+            buffer = writePair(buffer, year / 100);
+            buffer = writePair(buffer, year % 100);
+            if (format == DateFormat::Iso) {
+                *buffer++ = '-';
+            }
+            buffer = writePair(buffer, date.month);
+            if (format == DateFormat::Iso) {
+                *buffer++ = '-';
+            }
+            return writePair(buffer, date.day);
+        }
+
+    } // namespace DateFormatting
+
+    /*
+    * Writes a date formatted as YYYY-MM-DD or YYYYMMDD into a buffer of at least 10 or 8 characters,
+    * without a terminating null character, and returns the end of the written characters.
+    * Throws std::out_of_range if the year is not between 0 and 9999, which the formats cannot represent.
+    */
+    constexpr char* formatDate(const Date& date, char* buffer, DateFormat format = DateFormat::Iso) {
+        return DateFormatting::writeFields(buffer, civilFromSerial(date.serialNumber()), format);
+    }
+
+    // Returns a date formatted as YYYY-MM-DD or YYYYMMDD
+    inline std::string toString(const Date& date, DateFormat format = DateFormat::Iso) {
+        char buffer[10];
+        return std::string(buffer, formatDate(date, buffer, format));
+    }
+
+    /*
+    * Writes the dates of a vector into a buffer, each one followed by the delimiter, as read by parseDates.
+    * Returns the number of characters written. The dates are converted to civil fields in batches with
+    * the vector instructions of DateConversion.h.
+    * Throws std::length_error if the buffer is too small, which must hold dates.size() * (width + 1) characters,
+    * and std::out_of_range if the year of a date is not between 0 and 9999, leaving the buffer partially written.
+    */
+    inline std::size_t formatDates(const DateVector& dates, std::span<char> buffer, DateFormat format = DateFormat::Iso, char delimiter = '\n') {
+        const std::size_t stride = DateParsing::width(format) + 1;
+        if (buffer.size() / stride < dates.size()) {
+            throw std::length_error("Buffer too small to format the dates.");
+        }
+        constexpr std::size_t batch_size = 64;
+        std::int32_t years[batch_size];
+        std::uint32_t months[batch_size];
+        std::uint32_t days[batch_size];
+        char* output = buffer.data();
+        const std::span<const Date::SerialType> serial_numbers = dates.serialNumbers();
+        for (std::size_t begin = 0; begin < serial_numbers.size(); begin += batch_size) {
+            const std::size_t size = std::min(batch_size, serial_numbers.size() - begin);
+            civilFromSerials(serial_numbers.subspan(begin, size), std::span(years, size), std::span(months, size), std::span(days, size));
+            for (std::size_t i = 0; i < size; ++i) {
+                output = DateFormatting::writeFields(output, CivilDate{ years[i], months[i], days[i] }, format);
+                *output++ = delimiter;
+            }
+        }
+        return std::size_t(output - buffer.data());
+    }
+
+} // namespace HKUltra
+
+#if defined(__cpp_lib_format)
+/*
+* std::format support: "{}" formats a date as YYYY-MM-DD, and "{:c}" as YYYYMMDD.
+*/
+template <>
+struct std::formatter<HKUltra::Date, char> {
+    HKUltra::DateFormat format_ = HKUltra::DateFormat::Iso;  // Format selected by the format specification
+
+    constexpr auto parse(std::format_parse_context& context) {
+        auto it = context.begin();
+        if (it != context.end() && *it == 'c') {
+            format_ = HKUltra::DateFormat::Compact;
+            ++it;
+        }
+        if (it != context.end() && *it != '}') {
+            throw std::format_error("Invalid format specification for Date.");
+        }
+        return it;
+    }
+
+    template <typename _context>
+    auto format(const HKUltra::Date& date, _context& context) const {
+        char buffer[10];
+        return std::copy(buffer, HKUltra::formatDate(date, buffer, format_), context.out());
+    }
+};
+#endif
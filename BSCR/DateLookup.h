@@ -0,0 +1,150 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "DateConversion.h"
+
+// Window of years covered by the lookup tables, which can be overridden at build time
+#ifndef HKULTRA_DATE_LOOKUP_FIRST_YEAR
+#define HKULTRA_DATE_LOOKUP_FIRST_YEAR 1900
+#endif
+#ifndef HKULTRA_DATE_LOOKUP_LAST_YEAR
+#define HKULTRA_DATE_LOOKUP_LAST_YEAR 2200
+#endif
+
+namespace HKUltra {
+
+    namespace DateLookup {
+
+        /*
+        * Table holds, for the years `_first_year` to `_last_year`, the serial number of the first day of each year
+        * and of each month, and the month of each day of the year for common and leap years.
+        * It is built at compile time. The year, month and day of a date then take three table loads,
+        * and adding months to a date takes two, without any leap-year test nor month-length array.
+        */
+        template <std::int32_t _first_year, std::int32_t _last_year>
+        struct Table {
+            static_assert(_first_year <= _last_year, "The lookup window must not be empty.");
+
+            static constexpr std::int32_t first_year = _first_year;
+            static constexpr std::int32_t last_year = _last_year;
+            static constexpr std::size_t years = std::size_t(_last_year - _first_year + 1);
+
+            std::int32_t year_starts[years + 1];  // January 1st of each year, and of the year after the last one
+            std::int32_t month_starts[12 * years + 1];  // First day of each month, and of the month after the last one
+            std::uint8_t months_of_days[2][366];  // Month of each day of the year, in common and leap years
+
+            constexpr Table() : year_starts(), month_starts(), months_of_days() {
+                for (std::size_t year = 0; year <= years; ++year) {
+                    year_starts[year] = serialFromCivil(_first_year + std::int32_t(year), 1, 1);
+                }
+                for (std::size_t month = 0; month <= 12 * years; ++month) {
+                    month_starts[month] = serialFromCivil(_first_year + std::int32_t(month / 12), std::uint32_t(month % 12) + 1, 1);
+                }
+                const std::int32_t leap_year = 2000;  // Any leap year and the common year after it
+                for (std::uint32_t leap = 0; leap < 2; ++leap) {
+                    const std::int32_t year = leap ? leap_year : leap_year + 1;
+                    const std::int32_t start = serialFromCivil(year, 1, 1);
+                    for (std::int32_t day = 0; day < 365 + std::int32_t(leap); ++day) {
+                        months_of_days[leap][day] = std::uint8_t(civilFromSerial(start + day).month);
+                    }
+                }
+            }
+
+            // Returns true if the table covers a year
+            constexpr bool containsYear(std::int32_t year) const {
+                return year >= _first_year && year <= _last_year;
+            }
+
+            // Returns true if the table covers a serial number
+            constexpr bool contains(std::int32_t serial_number) const {
+                return serial_number >= year_starts[0] && serial_number < year_starts[years];
+            }
+
+            // Index of the year of a serial number covered by the table
+            constexpr std::size_t yearIndex(std::int32_t serial_number) const {
+                // The mean year length gives the year to within one year; one comparison on each side corrects it
+                std::size_t year = std::min(std::size_t(std::int64_t(serial_number - year_starts[0]) * 400 / 146097), years - 1);
+                year -= serial_number < year_starts[year];
+                year += serial_number >= year_starts[year + 1];
+                return year;
+            }
+
+            // Year, month and day of a serial number covered by the table
+            constexpr CivilDate civil(std::int32_t serial_number) const {
+                const std::size_t year = yearIndex(serial_number);
+                const std::int32_t day_of_year = serial_number - year_starts[year];
+                const std::size_t leap = std::size_t(year_starts[year + 1] - year_starts[year] - 365);
+                const std::uint32_t month = months_of_days[leap][day_of_year];
+                return CivilDate{ _first_year + std::int32_t(year), month,
+                    std::uint32_t(serial_number - month_starts[12 * year + month - 1]) + 1 };
+            }
+        };
+
+        // Table of the configured window
+        inline constexpr Table<HKULTRA_DATE_LOOKUP_FIRST_YEAR, HKULTRA_DATE_LOOKUP_LAST_YEAR> table;
+
+        // Year, month and day of a serial number: looked up in the window, computed with civilFromSerial outside it
+        constexpr CivilDate civil(std::int32_t serial_number) {
+            return table.contains(serial_number) ? table.civil(serial_number) : civilFromSerial(serial_number);
+        }
+
+        // Serial number of January 1st of a year
+        constexpr std::int32_t yearStart(std::int32_t year) {
+            return table.containsYear(year) || year == table.last_year + 1
+                ? table.year_starts[year - table.first_year] : serialFromCivil(year, 1, 1);
+        }
+
+        // Serial number of the first day of a month
+        constexpr std::int32_t monthStart(std::int32_t year, std::uint32_t month) {
+            return table.containsYear(year)
+                ? table.month_starts[12 * std::size_t(year - table.first_year) + month - 1] : serialFromCivil(year, month, 1);
+        }
+
+        // Number of days of a month
+        constexpr std::uint32_t daysInMonth(std::int32_t year, std::uint32_t month) {
+            if (table.containsYear(year)) {
+                const std::size_t index = 12 * std::size_t(year - table.first_year) + month - 1;
+                return std::uint32_t(table.month_starts[index + 1] - table.month_starts[index]);
+            }
+            return std::uint32_t(serialFromCivil(year + std::int32_t(month / 12), month % 12 + 1, 1) - serialFromCivil(year, month, 1));
+        }
+
+        // Day of the year of a serial number, from 1 for January 1st
+        constexpr std::uint32_t dayOfYear(std::int32_t serial_number) {
+            return std::uint32_t(serial_number - yearStart(civil(serial_number).year)) + 1;
+        }
+
+        // Day of the week of a serial number, from 0 for Sunday to 6 for Saturday, as std::chrono::weekday::c_encoding
+        constexpr std::uint32_t weekday(std::int32_t serial_number) {
+            return std::uint32_t((std::int64_t(serial_number) % 7 + 11) % 7);  // 1970-01-01 is a Thursday
+        }
+
+        // Serial number of the last day of the month of a serial number
+        constexpr std::int32_t monthEnd(std::int32_t serial_number) {
+            const CivilDate date = civil(serial_number);
+            return monthStart(date.year, date.month) + std::int32_t(daysInMonth(date.year, date.month)) - 1;
+        }
+
+        /*
+        * Adds a number of months to a serial number, keeping its day of the month
+        * clamped to the last day of the new month.
+        */
+        constexpr std::int32_t addMonths(std::int32_t serial_number, std::int32_t months) {
+            const CivilDate date = civil(serial_number);
+            const std::int32_t month_index = (date.year - table.first_year) * 12 + std::int32_t(date.month) - 1 + months;
+            if (month_index >= 0 && month_index < std::int32_t(12 * table.years)) {
+                // Both months are in the window: the month start and length are two adjacent loads
+                const std::int32_t start = table.month_starts[month_index];
+                const std::uint32_t days = std::uint32_t(table.month_starts[month_index + 1] - start);
+                return start + std::int32_t(std::min(date.day, days)) - 1;
+            }
+            // Floor division, so that months before the window are handled too
+            const std::int32_t year = (month_index >= 0 ? month_index : month_index - 11) / 12;
+            const std::uint32_t month = std::uint32_t(month_index - year * 12) + 1;
+            return serialFromCivil(table.first_year + year, month, std::min(date.day, daysInMonth(table.first_year + year, month)));
+        }
+
+    } // namespace DateLookup
+
+} // namespace HKUltra
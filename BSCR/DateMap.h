@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include "Date.h"
+
+namespace HKUltra {
+
+    /*
+    * DateMap maps dates to values of type _type. Dates in a window [first, last] are stored in an array indexed by
+    * serial number minus the serial number of the first date, so a lookup is one bounds check and one indexed load,
+    * with no tree walk nor hash probe.
+    * With _sparse, dates outside the window go to a hash map (see std::hash<Date>); without it,
+    * they are rejected with std::out_of_range.
+    * Like TimeSeries, a DateMap is not synchronized: it can be read concurrently, but must not be modified while being read.
+    */
+    template <typename _type, bool _sparse = true>
+    class DateMap {
+    public:
+        typedef Date::SerialType SerialType;  // Alias for the serial number type of the dates
+        typedef _type ValueType;  // Alias for the type of the values
+
+        // Creates an empty map with a dense window [first, last]. Throws std::invalid_argument if last is before first
+        DateMap(const Date& first, const Date& last) : first_(first.serialNumber()) {
+            if (last < first) {
+                throw std::invalid_argument("DateMap window must not be empty.");
+            }
+            dense_.resize(std::size_t(last.serialNumber() - first.serialNumber()) + 1);
+        }
+
+        // First date of the dense window
+        Date first() const {
+            return Date(first_);
+        }
+
+        // Last date of the dense window
+        Date last() const {
+            return Date(SerialType(first_ + SerialType(dense_.size()) - 1));
+        }
+
+        // Number of dates with a value
+        std::size_t size() const {
+            return size_;
+        }
+
+        // Returns true if no date has a value
+        bool empty() const {
+            return size_ == 0;
+        }
+
+        // Returns the value of a date, or null if it has none
+        const _type* find(const Date& date) const {
+            if (const std::optional<_type>* slot = denseSlot(date)) {
+                return *slot ? &**slot : nullptr;
+            }
+            return findSparse(date);
+        }
+
+        _type* find(const Date& date) {
+            return const_cast<_type*>(static_cast<const DateMap&>(*this).find(date));
+        }
+
+        // Returns true if the date has a value
+        bool contains(const Date& date) const {
+            return find(date) != nullptr;
+        }
+
+        // Returns the value of a date, inserting a default value if it has none
+        _type& operator[](const Date& date) {
+            if (std::optional<_type>* slot = denseSlot(date)) {
+                if (!*slot) {
+                    slot->emplace();
+                    ++size_;
+                }
+                return **slot;
+            }
+            auto [it, inserted] = sparse().try_emplace(date);
+            size_ += inserted;
+            return it->second;
+        }
+
+        // Sets the value of a date
+        void set(const Date& date, const _type& value) {
+            (*this)[date] = value;
+        }
+
+        // Removes the value of a date. Returns true if it had one
+        bool erase(const Date& date) {
+            if (std::optional<_type>* slot = denseSlot(date)) {
+                if (!*slot) {
+                    return false;
+                }
+                slot->reset();
+                --size_;
+                return true;
+            }
+            const bool erased = sparse().erase(date) != 0;
+            size_ -= erased;
+            return erased;
+        }
+
+        // Removes all values, keeping the window
+        void clear() {
+            for (std::optional<_type>& slot : dense_) {
+                slot.reset();
+            }
+            sparse_.clear();
+            size_ = 0;
+        }
+
+        /*
+        * Calls function(date, value) for each date with a value: the dates of the window in order,
+        * then the dates outside the window in no particular order.
+        */
+        template <typename _function>
+        void forEach(_function function) const {
+            for (std::size_t i = 0; i < dense_.size(); ++i) {
+                if (dense_[i]) {
+                    function(Date(SerialType(first_ + SerialType(i))), *dense_[i]);
+                }
+            }
+            for (const auto& [date, value] : sparse_) {
+                function(date, value);
+            }
+        }
+
+    private:
+        SerialType first_;  // Serial number of the first date of the window
+        std::vector<std::optional<_type>> dense_;  // Values of the window, indexed by serial number - first_
+        std::unordered_map<Date, _type> sparse_;  // Values outside the window, used only with _sparse
+        std::size_t size_ = 0;  // Number of dates with a value
+
+        // Returns the slot of a date in the window, or null outside it. A single unsigned comparison checks both bounds
+        const std::optional<_type>* denseSlot(const Date& date) const {
+            const std::uint32_t index = std::uint32_t(date.serialNumber()) - std::uint32_t(first_);
+            return index < dense_.size() ? &dense_[index] : nullptr;
+        }
+
+        std::optional<_type>* denseSlot(const Date& date) {
+            return const_cast<std::optional<_type>*>(static_cast<const DateMap&>(*this).denseSlot(date));
+        }
+
+        // Returns the value of a date outside the window, or null if it has none
+        const _type* findSparse(const Date& date) const {
+            if constexpr (_sparse) {
+                auto it = sparse_.find(date);
+                return it != sparse_.end() ? &it->second : nullptr;
+            }
+            else {
+                throw std::out_of_range("Date outside the DateMap window.");
+            }
+        }
+
+        // Returns the map of the dates outside the window. Throws std::out_of_range without _sparse
+        std::unordered_map<Date, _type>& sparse() {
+            if constexpr (!_sparse) {
+                throw std::out_of_range("Date outside the DateMap window.");
+            }
+            return sparse_;
+        }
+    };
+
+} // namespace HKUltra
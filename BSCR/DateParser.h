@@ -0,0 +1,340 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "Date.h"
+#include "DateConversion.h"
+#include "DateLookup.h"
+#include "DateVector.h"
+
+namespace HKUltra {
+
+    // Text formats of dates
+    enum class DateFormat {
+        Iso,      // YYYY-MM-DD
+        Compact   // YYYYMMDD
+    };
+
+    namespace DateParsing {
+
+        // Number of characters of a date in a format
+        constexpr std::size_t width(DateFormat format) {
+            return format == DateFormat::Iso ? 10 : 8;
+        }
+
+        // Returns the value of a digit, or a value above 9 if the character is not a digit
+        constexpr std::uint32_t digit(char character) {
+            return std::uint32_t(static_cast<unsigned char>(character)) - '0';
+        }
+
+        // Offsets of the month and day digits in a format
+        constexpr std::size_t monthStart(DateFormat format) {
+            return format == DateFormat::Iso ? 5 : 4;
+        }
+
+        constexpr std::size_t dayStart(DateFormat format) {
+            return format == DateFormat::Iso ? 8 : 6;
+        }
+
+        /*
+        * Reads the fields of the `width(format)` characters of a date, whose digits and separators
+        * must already have been checked.
+        */
+        constexpr CivilDate readFields(const char* text, DateFormat format) {
+            const char* month = text + monthStart(format);
+            const char* day = text + dayStart(format);
+            return CivilDate{
+                std::int32_t(digit(text[0]) * 1000 + digit(text[1]) * 100 + digit(text[2]) * 10 + digit(text[3])),
+                digit(month[0]) * 10 + digit(month[1]),
+                digit(day[0]) * 10 + digit(day[1]) };
+        }
+
+        // Returns true if the month and day of a date exist
+        constexpr bool isValid(const CivilDate& date) {
+            if (date.month < 1 || date.month > 12 || date.day < 1) {
+                return false;
+            }
+            return date.day <= DateLookup::daysInMonth(date.year, date.month);
+        }
+
+        /*
+        * Parses and validates the `width(format)` characters of a date.
+        * Returns false if the text is malformed or the date does not exist.
+        */
+        constexpr bool parseFields(const char* text, DateFormat format, CivilDate& date) {
+            if (format == DateFormat::Iso && (text[4] != '-' || text[7] != '-')) {
+                return false;
+            }
+            const std::size_t month_start = monthStart(format);
+            const std::size_t day_start = dayStart(format);
+            const std::uint32_t digits[8] = {
+                digit(text[0]), digit(text[1]), digit(text[2]), digit(text[3]),
+                digit(text[month_start]), digit(text[month_start + 1]), digit(text[day_start]), digit(text[day_start + 1]) };
+            for (std::uint32_t value : digits) {
+                if (value > 9) {
+                    return false;
+                }
+            }
+            date = readFields(text, format);
+            return isValid(date);
+        }
+
+        // Throws the exception reporting a malformed date
+        [[noreturn]] inline void throwInvalidDate(std::size_t offset) {
+            throw std::invalid_argument("Invalid date at offset " + std::to_string(offset) + ".");
+        }
+
+#if defined(__AVX2__) || defined(__SSE4_1__) || defined(__AVX__)
+        using DateConversion::VectorType;
+        constexpr std::size_t vector_size = sizeof(VectorType);  // Number of characters checked at once
+
+#if defined(__AVX2__)
+        inline VectorType broadcastByte(char value) { return _mm256_set1_epi8(value); }
+        inline VectorType subtractBytes(VectorType a, VectorType b) { return _mm256_sub_epi8(a, b); }
+        inline VectorType equalBytes(VectorType a, VectorType b) { return _mm256_cmpeq_epi8(a, b); }
+        inline VectorType minimumBytes(VectorType a, VectorType b) { return _mm256_min_epu8(a, b); }
+        inline VectorType select(VectorType mask, VectorType a, VectorType b) { return _mm256_blendv_epi8(b, a, mask); }  // a where mask is set, b elsewhere
+        inline bool allSet(VectorType mask) { return _mm256_movemask_epi8(mask) == -1; }
+#else
+        inline VectorType broadcastByte(char value) { return _mm_set1_epi8(value); }
+        inline VectorType subtractBytes(VectorType a, VectorType b) { return _mm_sub_epi8(a, b); }
+        inline VectorType equalBytes(VectorType a, VectorType b) { return _mm_cmpeq_epi8(a, b); }
+        inline VectorType minimumBytes(VectorType a, VectorType b) { return _mm_min_epu8(a, b); }
+        inline VectorType select(VectorType mask, VectorType a, VectorType b) { return _mm_blendv_epi8(b, a, mask); }  // a where mask is set, b elsewhere
+        inline bool allSet(VectorType mask) { return _mm_movemask_epi8(mask) == 0xFFFF; }
+#endif
+
+        /*
+        * RecordPattern describes the characters expected in a block of `vector_size` records, each record being a date
+        * followed by a delimiter. Since a block holds a whole number of records, it spans exactly `stride` vectors,
+        * so checking a block checks every digit, separator and delimiter of several dates with each instruction.
+        */
+        class RecordPattern {
+        public:
+            static constexpr std::size_t max_stride = 11;  // Length of a record in the longest format
+
+            RecordPattern(DateFormat format, char delimiter) : stride_(width(format) + 1) {
+                for (std::size_t i = 0; i < stride_ * vector_size; ++i) {
+                    const std::size_t position = i % stride_;  // Position of the character in its record
+                    const bool is_digit = position < width(format) && !(format == DateFormat::Iso && (position == 4 || position == 7));
+                    digits_[i] = is_digit ? char(0xFF) : 0;
+                    literals_[i] = is_digit ? 0 : (position == width(format) ? delimiter : '-');
+                }
+            }
+
+            // Number of characters of a record
+            std::size_t stride() const {
+                return stride_;
+            }
+
+            // Returns true if the `stride() * vector_size` characters of a block match the pattern
+            bool matches(const char* block) const {
+                const VectorType zero = broadcastByte('0');
+                const VectorType nine = broadcastByte(9);
+                VectorType result = equalBytes(zero, zero);  // All ones
+                for (std::size_t offset = 0; offset < stride_ * vector_size; offset += vector_size) {
+                    const VectorType text = DateConversion::load(block + offset);
+                    const VectorType values = subtractBytes(text, zero);
+                    const VectorType is_digit = equalBytes(minimumBytes(values, nine), values);  // Unsigned values up to 9
+                    const VectorType is_literal = equalBytes(text, DateConversion::load(literals_ + offset));
+                    const VectorType expected = select(DateConversion::load(digits_ + offset), is_digit, is_literal);
+                    result = DateConversion::bitAnd(result, expected);
+                }
+                return allSet(result);
+            }
+
+        private:
+            std::size_t stride_;  // Number of characters of a record
+            char digits_[max_stride * vector_size];  // 0xFF where a digit is expected
+            char literals_[max_stride * vector_size];  // Expected separator or delimiter elsewhere
+        };
+#endif
+
+    } // namespace DateParsing
+
+    /*
+    * Parses a date formatted as YYYY-MM-DD or YYYYMMDD.
+    * Returns false, leaving `date` unchanged, if the text is malformed or the date does not exist.
+    */
+    constexpr bool tryParseDate(std::string_view text, Date& date) {
+        CivilDate civil_date{};
+        if (text.size() == DateParsing::width(DateFormat::Iso)) {
+            if (!DateParsing::parseFields(text.data(), DateFormat::Iso, civil_date)) {
+                return false;
+            }
+        }
+        else if (text.size() == DateParsing::width(DateFormat::Compact)) {
+            if (!DateParsing::parseFields(text.data(), DateFormat::Compact, civil_date)) {
+                return false;
+            }
+        }
+        else {
+            return false;
+        }
+        date = Date(serialFromCivil(civil_date));
+        return true;
+    }
+
+    /*
+    * Parses a date formatted as YYYY-MM-DD or YYYYMMDD.
+    * Throws std::invalid_argument if the text is malformed or the date does not exist.
+    */
+    inline Date parseDate(std::string_view text) {
+        Date date;
+        if (!tryParseDate(text, date)) {
+            DateParsing::throwInvalidDate(0);
+        }
+        return date;
+    }
+
+    namespace DateParsing {
+
+        /*
+        * Implements parseDates for a buffer starting at `offset` in a larger input, which is added to the offsets
+        * reported by errors.
+        */
+        inline void parseRecords(std::string_view buffer, DateVector& dates, DateFormat format, char delimiter, std::size_t offset) {
+            const std::size_t width = DateParsing::width(format);
+            const std::size_t stride = width + 1;
+            const std::size_t count = (buffer.size() + 1) / stride;  // The last delimiter is optional
+            if (buffer.size() != count * stride && buffer.size() != count * stride - 1) {
+                DateParsing::throwInvalidDate(offset + count * stride);  // Truncated date at the end of the buffer
+            }
+            const std::size_t first = dates.size();
+            dates.resize(first + count);
+            const std::span<Date::SerialType> serial_numbers = dates.serialNumbers().subspan(first);
+
+            /*
+            * Parses the dates [begin, end) into civil fields, then converts them to serial numbers at once.
+            * The digits, separators and delimiters of a well formed batch were already checked with vector
+            * instructions: only their month and day are validated.
+            */
+            constexpr std::size_t batch_size = 64;
+            std::int32_t years[batch_size];
+            std::uint32_t months[batch_size];
+            std::uint32_t days[batch_size];
+            auto parseBatch = [&](std::size_t begin, std::size_t end, bool well_formed) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    const char* text = buffer.data() + i * stride;
+                    CivilDate date{};
+                    const bool valid = well_formed
+                        ? DateParsing::isValid(date = DateParsing::readFields(text, format))
+                        : DateParsing::parseFields(text, format, date) && (i * stride + width == buffer.size() || text[width] == delimiter);
+                    if (!valid) {
+                        dates.resize(first);  // Leave the vector unchanged
+                        DateParsing::throwInvalidDate(offset + i * stride);
+                    }
+                    years[i - begin] = date.year;
+                    months[i - begin] = date.month;
+                    days[i - begin] = date.day;
+                }
+                const std::size_t size = end - begin;
+                serialsFromCivil(std::span(years, size), std::span(months, size), std::span(days, size), serial_numbers.subspan(begin, size));
+            };
+
+            std::size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE4_1__) || defined(__AVX__)
+            // Checks the characters of whole blocks of records with vector instructions, each one ending with a delimiter
+            static_assert(batch_size % DateParsing::vector_size == 0, "Batches must hold whole blocks.");
+            const DateParsing::RecordPattern pattern(format, delimiter);
+            const std::size_t block_size = DateParsing::vector_size;  // Number of records of a block
+            while (i + batch_size <= count && (i + batch_size) * stride <= buffer.size()) {
+                bool well_formed = true;
+                for (std::size_t block = i; block < i + batch_size; block += block_size) {
+                    well_formed = well_formed && pattern.matches(buffer.data() + block * stride);
+                }
+                if (!well_formed) {
+                    break;  // The scalar parser locates the malformed date
+                }
+                parseBatch(i, i + batch_size, true);
+                i += batch_size;
+            }
+#endif
+            for (; i < count; i += batch_size) {  // Remaining dates
+                parseBatch(i, std::min(i + batch_size, count), false);
+            }
+        }
+
+    } // namespace DateParsing
+
+    /*
+    * Parses a buffer of dates in one format, each one followed by the delimiter (which may be omitted after the last one),
+    * and appends them to `dates`. For instance "2023-01-01\n2023-01-02\n" with DateFormat::Iso and '\n'.
+    * Blocks of dates are checked with vector instructions, and their serial numbers are computed by the batch
+    * conversion of DateConversion.h.
+    * Throws std::invalid_argument, with the offset of the first malformed or invalid date, and leaves `dates` unchanged.
+    */
+    inline void parseDates(std::string_view buffer, DateVector& dates, DateFormat format = DateFormat::Iso, char delimiter = '\n') {
+        DateParsing::parseRecords(buffer, dates, format, delimiter, 0);
+    }
+
+    /*
+    * DateStreamParser parses a stream of dates delivered in chunks, for instance successive windows of a
+    * memory-mapped file or successive reads of a file, and appends them to a DateVector.
+    * Dates split across two chunks are carried over to the next chunk. The format is the one of parseDates,
+    * and errors report offsets in the whole stream.
+    */
+    class DateStreamParser {
+    public:
+        DateStreamParser(DateVector& dates, DateFormat format = DateFormat::Iso, char delimiter = '\n')
+            : dates_(dates), format_(format), delimiter_(delimiter) {}
+
+        /*
+        * Parses the dates of a chunk. The characters of a date split at the end of the chunk are kept
+        * until the next chunk. Throws std::invalid_argument if a date is malformed, leaving the vector and
+        * the parser as they were before the call, so no date of the chunk is consumed.
+        */
+        void parse(std::string_view chunk) {
+            const std::size_t stride = DateParsing::width(format_) + 1;
+            std::size_t carried = 0;  // Characters of the record carried over from the previous chunk
+            if (!pending_.empty()) {
+                const std::size_t missing = stride - pending_.size();
+                if (chunk.size() < missing) {
+                    pending_.append(chunk);  // Still incomplete
+                    return;
+                }
+                carried = pending_.size();
+            }
+            const std::size_t first = dates_.size();
+            const std::size_t start = carried ? stride - carried : 0;  // Start of the complete records of the chunk
+            const std::size_t whole = (chunk.size() - start) / stride * stride;  // Characters of the complete records
+            try {
+                if (carried) {  // Complete the date carried over from the previous chunk
+                    char record[DateParsing::width(DateFormat::Iso) + 1];
+                    std::copy(pending_.begin(), pending_.end(), record);
+                    std::copy(chunk.begin(), chunk.begin() + start, record + carried);
+                    DateParsing::parseRecords(std::string_view(record, stride), dates_, format_, delimiter_, offset_);
+                }
+                DateParsing::parseRecords(chunk.substr(start, whole), dates_, format_, delimiter_, offset_ + carried + start);
+            }
+            catch (...) {
+                dates_.resize(first);  // Drop the carried date if the rest of the chunk is malformed
+                throw;
+            }
+            offset_ += carried + start + whole;
+            pending_.assign(chunk.substr(start + whole));
+        }
+
+        /*
+        * Parses the last date, which may have no delimiter. Throws std::invalid_argument if it is truncated.
+        */
+        void finish() {
+            if (!pending_.empty()) {
+                DateParsing::parseRecords(pending_, dates_, format_, delimiter_, offset_);
+                offset_ += pending_.size();
+                pending_.clear();
+            }
+        }
+
+    private:
+        DateVector& dates_;  // Vector the dates are appended to
+        DateFormat format_;  // Format of the dates
+        char delimiter_;  // Character following each date
+        std::string pending_;  // Characters of a date split across chunks
+        std::size_t offset_ = 0;  // Offset in the stream of the first character not parsed yet, the start of pending_
+    };
+
+} // namespace HKUltra
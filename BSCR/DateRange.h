@@ -0,0 +1,192 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include "Calendar.h"
+#include "Date.h"
+#include "DateConversion.h"
+#include "DateLookup.h"
+
+namespace HKUltra {
+
+    // DateRangeEnd is the sentinel of the date ranges: iterators reach it at the first date on or after the end date
+    struct DateRangeEnd {
+        Date::SerialType serial_number;  // Serial number of the end date, excluded from the range
+    };
+
+    /*
+    * DayRange is a lazy view of the dates from a start date (included) to an end date (excluded), every `step` days.
+    * Incrementing an iterator adds the step to a serial number; no date is stored.
+    */
+    class DayRange : public std::ranges::view_interface<DayRange> {
+    public:
+        class Iterator {
+        public:
+            typedef Date value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef std::forward_iterator_tag iterator_concept;
+
+            Iterator() = default;
+            Iterator(Date::SerialType serial_number, Date::SerialType step) : serial_number_(serial_number), step_(step) {}
+
+            Date operator*() const {
+                return Date(serial_number_);
+            }
+
+            Iterator& operator++() {
+                serial_number_ += step_;  // Integer addition only
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            bool operator==(const Iterator& rhs) const = default;
+
+            bool operator==(const DateRangeEnd& end) const {
+                return serial_number_ >= end.serial_number;
+            }
+
+        private:
+            Date::SerialType serial_number_ = 0;  // Serial number of the current date
+            Date::SerialType step_ = 1;  // Number of days between two dates
+        };
+
+        DayRange() = default;
+        DayRange(const Date& start, const Date& end, const Days& step)
+            : start_(start.serialNumber()), end_(end.serialNumber()), step_(static_cast<Date::SerialType>(step.count())) {
+            if (step_ <= 0) {
+                throw std::invalid_argument("Date range step must be positive.");
+            }
+        }
+
+        Iterator begin() const {
+            return Iterator(start_, step_);
+        }
+
+        DateRangeEnd end() const {
+            return DateRangeEnd{ end_ };
+        }
+
+    private:
+        Date::SerialType start_ = 0;  // Serial number of the first date
+        Date::SerialType end_ = 0;  // Serial number of the end date, excluded
+        Date::SerialType step_ = 1;  // Number of days between two dates
+    };
+
+    /*
+    * MonthRange is a lazy view of the dates from a start date (included) to an end date (excluded), every `step` months.
+    * Each date keeps the day of the start date, clamped to the end of shorter months, like Date::operator+(Months).
+    * Iterators keep a month counter: incrementing one adds the step to it and looks up the first day and length
+    * of the new month in the tables of DateLookup.h.
+    */
+    class MonthRange : public std::ranges::view_interface<MonthRange> {
+    public:
+        class Iterator {
+        public:
+            typedef Date value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef std::forward_iterator_tag iterator_concept;
+
+            Iterator() = default;
+            Iterator(const Date& start, std::int32_t step) : step_(step) {
+                const CivilDate date = civilFromSerial(start.serialNumber());
+                month_index_ = date.year * 12 + std::int32_t(date.month) - 1;
+                day_ = date.day;
+                serial_number_ = start.serialNumber();
+            }
+
+            Date operator*() const {
+                return Date(serial_number_);
+            }
+
+            Iterator& operator++() {
+                month_index_ += step_;
+                // Floor division, so that months before year 0 are handled too
+                const std::int32_t year = (month_index_ >= 0 ? month_index_ : month_index_ - 11) / 12;
+                const std::uint32_t month = std::uint32_t(month_index_ - year * 12) + 1;
+                const std::uint32_t day = std::min(day_, DateLookup::daysInMonth(year, month));
+                serial_number_ = DateLookup::monthStart(year, month) + Date::SerialType(day) - 1;
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            bool operator==(const Iterator& rhs) const {
+                return serial_number_ == rhs.serial_number_;
+            }
+
+            bool operator==(const DateRangeEnd& end) const {
+                return serial_number_ >= end.serial_number;
+            }
+
+        private:
+            std::int32_t month_index_ = 0;  // Year * 12 + month - 1 of the current date
+            std::int32_t step_ = 1;  // Number of months between two dates
+            std::uint32_t day_ = 1;  // Day of the start date
+            Date::SerialType serial_number_ = 0;  // Serial number of the current date
+        };
+
+        MonthRange() = default;
+        MonthRange(const Date& start, const Date& end, const Months& step)
+            : start_(start), end_(end.serialNumber()), step_(static_cast<std::int32_t>(step.count())) {
+            if (step_ <= 0) {
+                throw std::invalid_argument("Date range step must be positive.");
+            }
+        }
+
+        Iterator begin() const {
+            return Iterator(start_, step_);
+        }
+
+        DateRangeEnd end() const {
+            return DateRangeEnd{ end_ };
+        }
+
+    private:
+        Date start_;  // First date
+        Date::SerialType end_ = 0;  // Serial number of the end date, excluded
+        std::int32_t step_ = 1;  // Number of months between two dates
+    };
+
+    /*
+    * Returns a lazy view of the dates in [start, end), every `step` days, months or years.
+    * The views compose with the standard range adaptors, e.g. dateRange(start, end, Days(1)) | std::views::filter(...).
+    */
+    inline DayRange dateRange(const Date& start, const Date& end, const Days& step) {
+        return DayRange(start, end, step);
+    }
+
+    inline MonthRange dateRange(const Date& start, const Date& end, const Months& step) {
+        return MonthRange(start, end, step);
+    }
+
+    inline MonthRange dateRange(const Date& start, const Date& end, const Years& step) {
+        return MonthRange(start, end, Months(12 * step.count()));
+    }
+
+    /*
+    * Range adaptor keeping the business days of a calendar, e.g. dateRange(start, end, Days(1)) | businessDays(calendar).
+    * The calendar must outlive the view.
+    */
+    inline auto businessDays(const Calendar& calendar) {
+        return std::views::filter([&calendar](const Date& date) { return calendar.isBusinessDay(date); });
+    }
+
+} // namespace HKUltra
+
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<HKUltra::DayRange> = true;
+
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<HKUltra::MonthRange> = true;
@@ -0,0 +1,150 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <vector>
+#include "Date.h"
+#include "DateConversion.h"
+
+namespace HKUltra {
+
+    /*
+    * DateVector is a columnar container of dates: it stores their serial numbers contiguously,
+    * so whole schedules can be shifted at once by the bulk addDays, addMonths and addYears methods.
+    * Month and year shifts clamp to the end of the month like Date::operator+=, and are computed with
+    * the vector instructions of DateConversion.h (AVX2 or SSE4.1) when the target supports them.
+    * Like Date, DateVector is not synchronized: it is a value owned by one thread at a time.
+    */
+    class DateVector {
+    public:
+        typedef Date::SerialType SerialType;  // Alias for the serial number type of the dates
+
+        // Default constructor: creates an empty vector
+        DateVector() = default;
+
+        // Creates a vector of `size` copies of a date
+        explicit DateVector(std::size_t size, Date date = Date()) : serial_numbers_(size, date.serialNumber()) {}
+
+        // Creates a vector from a list of dates
+        DateVector(std::initializer_list<Date> dates) {
+            serial_numbers_.reserve(dates.size());
+            for (const Date& date : dates) {
+                serial_numbers_.push_back(date.serialNumber());
+            }
+        }
+
+        // Number of dates in the vector
+        std::size_t size() const {
+            return serial_numbers_.size();
+        }
+
+        // Returns true if the vector holds no dates
+        bool empty() const {
+            return serial_numbers_.empty();
+        }
+
+        // Reserves storage for `capacity` dates
+        void reserve(std::size_t capacity) {
+            serial_numbers_.reserve(capacity);
+        }
+
+        // Removes all the dates
+        void clear() {
+            serial_numbers_.clear();
+        }
+
+        // Resizes the vector, new dates being copies of `date`
+        void resize(std::size_t size, Date date = Date()) {
+            serial_numbers_.resize(size, date.serialNumber());
+        }
+
+        // Appends a date at the end of the vector
+        void pushBack(Date date) {
+            serial_numbers_.push_back(date.serialNumber());
+        }
+
+        // Returns the date at `index`
+        Date operator[](std::size_t index) const {
+            return Date(serial_numbers_[index]);
+        }
+
+        // Replaces the date at `index`
+        void set(std::size_t index, Date date) {
+            serial_numbers_[index] = date.serialNumber();
+        }
+
+        // Column of the serial numbers of the dates
+        std::span<SerialType> serialNumbers() {
+            return serial_numbers_;
+        }
+
+        std::span<const SerialType> serialNumbers() const {
+            return serial_numbers_;
+        }
+
+        // Adds a duration of days to every date
+        DateVector& addDays(const Days& days) {
+            const SerialType offset = static_cast<SerialType>(days.count());
+            for (SerialType& serial_number : serial_numbers_) {  // Plain integer additions, vectorized by the compiler
+                serial_number += offset;
+            }
+            return *this;
+        }
+
+        // Adds a duration of months to every date, clamping to the last day of the month
+        DateVector& addMonths(const Months& months) {
+            const std::int32_t offset = static_cast<std::int32_t>(months.count());
+            std::size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE4_1__) || defined(__AVX__)
+            const DateConversion::VectorType vector_offset = DateConversion::broadcast(std::uint32_t(offset));
+            for (; i + DateConversion::lanes <= serial_numbers_.size(); i += DateConversion::lanes) {
+                DateConversion::store(&serial_numbers_[i], addMonths(DateConversion::load(&serial_numbers_[i]), vector_offset));
+            }
+#endif
+            for (; i < serial_numbers_.size(); ++i) {  // Remaining dates
+                serial_numbers_[i] = (Date(serial_numbers_[i]) + Months(offset)).serialNumber();
+            }
+            return *this;
+        }
+
+        // Adds a duration of years to every date, clamping February 29th to February 28th in non-leap years
+        DateVector& addYears(const Years& years) {
+            return addMonths(Months(12 * years.count()));  // Same end of month clamping as 12 months
+        }
+
+    private:
+        std::vector<SerialType> serial_numbers_;  // Serial numbers of the dates
+
+#if defined(__AVX2__) || defined(__SSE4_1__) || defined(__AVX__)
+        // Adds months to each date of a vector, clamping to the last day of the month
+        static DateConversion::VectorType addMonths(DateConversion::VectorType serial_number, DateConversion::VectorType months) {
+            using namespace DateConversion;
+            VectorType year, month, day;
+            DateConversion::civilFromSerial(serial_number, year, month, day);
+            // Count months from the shifted year 0, so the division by 12 stays unsigned
+            const VectorType month_index = add(add(multiply(add(year, broadcast(year_shift)), broadcast(12)), subtract(month, broadcast(1))), months);
+            const VectorType shifted_year = multiplyHigh<24>(month_index, broadcast(1398102));  // month_index / 12
+            const VectorType new_month = add(subtract(month_index, multiply(shifted_year, broadcast(12))), broadcast(1));
+            const VectorType new_day = minimum(day, lastDayOfMonth(shifted_year, new_month));
+            return DateConversion::serialFromCivil(subtract(shifted_year, broadcast(year_shift)), new_month, new_day);
+        }
+
+        // Computes the last day of each month of a vector, the years being shifted by DateConversion::year_shift
+        static DateConversion::VectorType lastDayOfMonth(DateConversion::VectorType shifted_year, DateConversion::VectorType month) {
+            using namespace DateConversion;
+            // The shift is a multiple of 400 years, so it does not change leap years
+            const VectorType century = multiplyHigh<24>(shifted_year, broadcast(167773));  // shifted_year / 100
+            const VectorType divisible_by_4 = equal(bitAnd(shifted_year, broadcast(3)), broadcast(0));
+            const VectorType divisible_by_100 = equal(shifted_year, multiply(century, broadcast(100)));
+            const VectorType divisible_by_400 = bitAnd(divisible_by_100, equal(bitAnd(century, broadcast(3)), broadcast(0)));
+            const VectorType leap = bitXor(bitXor(divisible_by_4, divisible_by_100), divisible_by_400);  // All ones for leap years
+            // 31 days for odd months up to July and even months from August, 30 otherwise
+            const VectorType last_day = add(broadcast(30), bitAnd(bitXor(month, shiftRight<3>(month)), broadcast(1)));
+            // February has 28 days, or 29 in leap years
+            return subtract(last_day, bitAnd(equal(month, broadcast(2)), add(broadcast(2), leap)));
+        }
+#endif
+    };
+
+} // namespace HKUltra
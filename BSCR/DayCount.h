@@ -0,0 +1,211 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include "Date.h"
+#include "DateConversion.h"
+#include "DateLookup.h"
+#include "DateVector.h"
+
+namespace HKUltra {
+
+    // Day-count conventions computing the fraction of a year between two dates
+    enum class DayCountConvention {
+        Actual360,           // Actual days / 360
+        Actual365Fixed,      // Actual days / 365
+        Thirty360US,         // 30/360 US (NASD): end of February counts as the 30th
+        Thirty360BondBasis,  // 30/360 ISDA bond basis: the 31st counts as the 30th, the end date only if the start date does
+        Thirty360European,   // 30E/360 Eurobond basis: the 31st always counts as the 30th
+        ActualActualISDA     // Actual days in each calendar year / days of that year (365 or 366)
+    };
+
+    namespace DayCounting {
+
+        /*
+        * YearTable holds, for the years of the DateLookup window (HKULTRA_DATE_LOOKUP_FIRST_YEAR to
+        * HKULTRA_DATE_LOOKUP_LAST_YEAR), the reciprocal of the number of days in the year, so ACT/ACT ISDA needs
+        * no division. It is built at compile time from the year starts of DateLookup::table; years outside the
+        * window are computed on the fly.
+        */
+        struct YearTable {
+            static constexpr std::int32_t first_year = DateLookup::table.first_year;
+            static constexpr std::int32_t last_year = DateLookup::table.last_year;
+
+            double reciprocals[DateLookup::table.years];  // 1 / number of days of each year
+
+            constexpr YearTable() : reciprocals() {
+                for (std::size_t year = 0; year < DateLookup::table.years; ++year) {
+                    reciprocals[year] = 1.0 / double(DateLookup::table.year_starts[year + 1] - DateLookup::table.year_starts[year]);
+                }
+            }
+        };
+
+        inline constexpr YearTable year_table;
+
+        // Serial number of January 1st of a year
+        constexpr Date::SerialType yearStart(std::int32_t year) {
+            return DateLookup::yearStart(year);
+        }
+
+        // Reciprocal of the number of days of a year
+        constexpr double yearReciprocal(std::int32_t year) {
+            if (year >= YearTable::first_year && year <= YearTable::last_year) {
+                return year_table.reciprocals[year - YearTable::first_year];
+            }
+            return 1.0 / double(yearStart(year + 1) - yearStart(year));
+        }
+
+        // Returns true if a date is the last day of February
+        constexpr bool isEndOfFebruary(const CivilDate& date) {
+            return date.month == 2 && date.day == DateLookup::daysInMonth(date.year, 2);
+        }
+
+        // Number of days between two dates under a 30/360 convention
+        template <DayCountConvention _convention>
+        constexpr std::int32_t thirty360Days(CivilDate start, CivilDate end) {
+            if constexpr (_convention == DayCountConvention::Thirty360US) {
+                if (isEndOfFebruary(start)) {
+                    if (isEndOfFebruary(end)) {
+                        end.day = 30;
+                    }
+                    start.day = 30;
+                }
+            }
+            const std::uint32_t start_day = std::min(start.day, 30u);
+            std::uint32_t end_day = end.day;
+            if constexpr (_convention == DayCountConvention::Thirty360European) {
+                end_day = std::min(end_day, 30u);
+            }
+            else {
+                end_day = start_day == 30 ? std::min(end_day, 30u) : end_day;
+            }
+            return 360 * (end.year - start.year) + 30 * (std::int32_t(end.month) - std::int32_t(start.month))
+                + (std::int32_t(end_day) - std::int32_t(start_day));
+        }
+
+        /*
+        * Year fraction between two dates, given both as serial numbers and as civil dates.
+        * The conventions are template parameters so that the batch loops have no branch on the convention.
+        */
+        template <DayCountConvention _convention>
+        constexpr double yearFraction(Date::SerialType start, const CivilDate& civil_start, Date::SerialType end, const CivilDate& civil_end) {
+            if constexpr (_convention == DayCountConvention::Actual360) {
+                return double(end - start) * (1.0 / 360.0);
+            }
+            else if constexpr (_convention == DayCountConvention::Actual365Fixed) {
+                return double(end - start) * (1.0 / 365.0);
+            }
+            else if constexpr (_convention == DayCountConvention::ActualActualISDA) {
+                // Whole years in between, plus the rest of the first year and the start of the last year;
+                // when both dates are in the same year this reduces to (end - start) / days of the year
+                return double(civil_end.year - civil_start.year - 1)
+                    + double(yearStart(civil_start.year + 1) - start) * yearReciprocal(civil_start.year)
+                    + double(end - yearStart(civil_end.year)) * yearReciprocal(civil_end.year);
+            }
+            else {
+                return double(thirty360Days<_convention>(civil_start, civil_end)) * (1.0 / 360.0);
+            }
+        }
+
+        // Computes the year fractions of a range of date pairs, converting the dates to civil dates in batches
+        template <DayCountConvention _convention>
+        void yearFractions(std::span<const Date::SerialType> starts, std::span<const Date::SerialType> ends, std::span<double> fractions) {
+            if constexpr (_convention == DayCountConvention::Actual360 || _convention == DayCountConvention::Actual365Fixed) {
+                for (std::size_t i = 0; i < fractions.size(); ++i) {  // Only serial numbers are needed, vectorized by the compiler
+                    fractions[i] = yearFraction<_convention>(starts[i], CivilDate{}, ends[i], CivilDate{});
+                }
+            }
+            else {
+                constexpr std::size_t batch_size = 64;
+                std::int32_t start_years[batch_size], end_years[batch_size];
+                std::uint32_t start_months[batch_size], end_months[batch_size];
+                std::uint32_t start_days[batch_size], end_days[batch_size];
+                for (std::size_t begin = 0; begin < fractions.size(); begin += batch_size) {
+                    const std::size_t size = std::min(batch_size, fractions.size() - begin);
+                    civilFromSerials(starts.subspan(begin, size), std::span(start_years, size), std::span(start_months, size), std::span(start_days, size));
+                    civilFromSerials(ends.subspan(begin, size), std::span(end_years, size), std::span(end_months, size), std::span(end_days, size));
+                    for (std::size_t i = 0; i < size; ++i) {
+                        fractions[begin + i] = yearFraction<_convention>(
+                            starts[begin + i], CivilDate{ start_years[i], start_months[i], start_days[i] },
+                            ends[begin + i], CivilDate{ end_years[i], end_months[i], end_days[i] });
+                    }
+                }
+            }
+        }
+
+    } // namespace DayCounting
+
+    /*
+    * Returns the fraction of a year between two dates under a day-count convention.
+    * The fraction is negative if the end date is before the start date.
+    */
+    constexpr double yearFraction(DayCountConvention convention, const Date& start, const Date& end) {
+        const Date::SerialType s = start.serialNumber();
+        const Date::SerialType e = end.serialNumber();
+        switch (convention) {
+        case DayCountConvention::Actual360:
+            return DayCounting::yearFraction<DayCountConvention::Actual360>(s, CivilDate{}, e, CivilDate{});
+        case DayCountConvention::Actual365Fixed:
+            return DayCounting::yearFraction<DayCountConvention::Actual365Fixed>(s, CivilDate{}, e, CivilDate{});
+        case DayCountConvention::Thirty360US:
+            return DayCounting::yearFraction<DayCountConvention::Thirty360US>(s, civilFromSerial(s), e, civilFromSerial(e));
+        case DayCountConvention::Thirty360BondBasis:
+            return DayCounting::yearFraction<DayCountConvention::Thirty360BondBasis>(s, civilFromSerial(s), e, civilFromSerial(e));
+        case DayCountConvention::Thirty360European:
+            return DayCounting::yearFraction<DayCountConvention::Thirty360European>(s, civilFromSerial(s), e, civilFromSerial(e));
+        case DayCountConvention::ActualActualISDA:
+            return DayCounting::yearFraction<DayCountConvention::ActualActualISDA>(s, civilFromSerial(s), e, civilFromSerial(e));
+        }
+        throw std::invalid_argument("Unknown day-count convention.");
+    }
+
+    /*
+    * Returns the number of days between two dates under a day-count convention:
+    * the actual number of days, or the 30/360 day count for the 30/360 conventions.
+    */
+    constexpr std::int32_t dayCount(DayCountConvention convention, const Date& start, const Date& end) {
+        const CivilDate s = civilFromSerial(start.serialNumber());
+        const CivilDate e = civilFromSerial(end.serialNumber());
+        switch (convention) {
+        case DayCountConvention::Thirty360US:
+            return DayCounting::thirty360Days<DayCountConvention::Thirty360US>(s, e);
+        case DayCountConvention::Thirty360BondBasis:
+            return DayCounting::thirty360Days<DayCountConvention::Thirty360BondBasis>(s, e);
+        case DayCountConvention::Thirty360European:
+            return DayCounting::thirty360Days<DayCountConvention::Thirty360European>(s, e);
+        default:
+            return end.serialNumber() - start.serialNumber();
+        }
+    }
+
+    /*
+    * Computes the year fractions between the dates of two columns, element by element, into `fractions`.
+    * The three spans must have the same size. The dates are converted to civil dates in batches with the
+    * vector instructions of DateConversion.h, and each convention runs its own branch-free loop.
+    */
+    inline void yearFractions(DayCountConvention convention, const DateVector& starts, const DateVector& ends, std::span<double> fractions) {
+        if (starts.size() != ends.size() || fractions.size() != starts.size()) {
+            throw std::invalid_argument("Date columns and fractions must have the same size.");
+        }
+        const std::span<const Date::SerialType> s = starts.serialNumbers();
+        const std::span<const Date::SerialType> e = ends.serialNumbers();
+        switch (convention) {
+        case DayCountConvention::Actual360:
+            return DayCounting::yearFractions<DayCountConvention::Actual360>(s, e, fractions);
+        case DayCountConvention::Actual365Fixed:
+            return DayCounting::yearFractions<DayCountConvention::Actual365Fixed>(s, e, fractions);
+        case DayCountConvention::Thirty360US:
+            return DayCounting::yearFractions<DayCountConvention::Thirty360US>(s, e, fractions);
+        case DayCountConvention::Thirty360BondBasis:
+            return DayCounting::yearFractions<DayCountConvention::Thirty360BondBasis>(s, e, fractions);
+        case DayCountConvention::Thirty360European:
+            return DayCounting::yearFractions<DayCountConvention::Thirty360European>(s, e, fractions);
+        case DayCountConvention::ActualActualISDA:
+            return DayCounting::yearFractions<DayCountConvention::ActualActualISDA>(s, e, fractions);
+        }
+        throw std::invalid_argument("Unknown day-count convention.");
+    }
+
+} // namespace HKUltra
@@ -0,0 +1,158 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+#include "LockPolicy.h"
+
+namespace HKUltra {
+
+    /*
+    * DependencyNode is a node of the graph linking ObservableValues to the Computed values derived from them.
+    * Each node has a rank: 0 for ObservableValues, and one more than the highest rank of its sources for Computed values.
+    * Changes of sources propagate in a Wave, to which each source is added just before its new value is stored (see Wave).
+    * Nodes must outlive the nodes depending on them, and the graph must not change while a wave runs.
+    */
+    class DependencyNode {
+    public:
+        /*
+        * Wave is a propagation wave, which brackets the store of the values of changed sources:
+        *  - add(), called before a source is stored, and only if its value changes, marks every node downstream of it
+        *    dirty and changing: values computed from sources being stored may miss the new values, so they are not cached;
+        *  - settle(), called once the values are stored, marks the nodes dirty again and no longer changing, so
+        *    the values computed meanwhile are computed again when read;
+        *  - refresh() then refreshes the nodes in rank order, so a node is recomputed after all of its sources
+        *    and at most once per wave, whatever the number of paths (diamonds) leading to it.
+        * Readers thus never receive a cached value older than a source value already stored.
+        * The destructor settles a wave that was not settled, for instance because a store threw.
+        */
+        class Wave {
+        public:
+            // Creates an empty wave: nothing is invalidated, and nothing allocated, until a changed source is added
+            Wave() = default;
+
+            ~Wave() {
+                settle();
+            }
+
+            Wave(const Wave&) = delete;
+            Wave& operator=(const Wave&) = delete;
+
+            /*
+            * Marks dirty and changing all the nodes depending, directly or not, on a source about to be stored,
+            * except those already in the wave. Must be called before the wave settles.
+            */
+            void add(DependencyNode& changed) {
+                std::vector<DependencyNode*> pending;
+                changed.collectDependents(pending);
+                if (pending.empty()) {
+                    return;  // Nothing depends on the source: nothing to allocate
+                }
+                if (!visited_) {
+                    visited_.emplace();
+                }
+                while (!pending.empty()) {
+                    DependencyNode* node = pending.back();
+                    pending.pop_back();
+                    if (!visited_->insert(node).second) {
+                        continue;  // Reached through another path of a diamond, or from another source
+                    }
+                    node->invalidate();
+                    node->collectDependents(pending);
+                    nodes_.push_back(node);
+                }
+            }
+
+            // Marks the nodes dirty again once the changed sources are stored, and puts them in rank order
+            void settle() {
+                if (!settled_) {
+                    settled_ = true;
+                    for (DependencyNode* node : nodes_) {
+                        node->settle();
+                    }
+                    std::stable_sort(nodes_.begin(), nodes_.end(), [](const DependencyNode* lhs, const DependencyNode* rhs) { return lhs->rank_ < rhs->rank_; });
+                }
+            }
+
+            // Settles the nodes if needed, then refreshes them in rank order
+            void refresh() {
+                settle();
+                for (DependencyNode* node : nodes_) {
+                    node->refresh();
+                }
+            }
+
+        private:
+            std::vector<DependencyNode*> nodes_;  // Nodes of the wave, in rank order once settled
+            std::optional<std::unordered_set<DependencyNode*>> visited_;  // Nodes of the wave, created with the first of them
+            bool settled_ = false;  // True once settle() ran
+        };
+
+        DependencyNode(const DependencyNode&) = delete;
+        DependencyNode& operator=(const DependencyNode&) = delete;
+        virtual ~DependencyNode() = default;
+
+        // Rank of the node in the dependency graph
+        std::uint32_t rank() const {
+            return rank_;
+        }
+
+    protected:
+        std::uint32_t rank_ = 0;  // Rank in the dependency graph
+
+        DependencyNode() = default;
+
+        // Marks the node dirty and changing, before its sources are stored; called on dependents only
+        virtual void invalidate() {}
+
+        // Marks the node dirty and no longer changing, once its sources are stored; called on dependents only
+        virtual void settle() {}
+
+        // Brings the node up to date after its sources changed; called on dependents only
+        virtual void refresh() {}
+
+        // Appends the nodes depending directly on this node to a list
+        virtual void collectDependents(std::vector<DependencyNode*>& nodes) const = 0;
+    };
+
+    /*
+    * BasicDependencyNode keeps the links of a node to its sources and dependents, synchronized with the _lock policy.
+    * Nodes of one graph use the same policy; graphs with different policies can still be refreshed in one wave.
+    */
+    template <typename _lock>
+    class BasicDependencyNode : public DependencyNode {
+    public:
+        // Destructor removes the node from the dependents of its sources
+        ~BasicDependencyNode() override {
+            for (BasicDependencyNode* source : sources_) {
+                WriteGuard<_lock> lock(source->mtx_);
+                source->dependents_.erase(std::find(source->dependents_.begin(), source->dependents_.end(), this));
+            }
+        }
+
+    protected:
+        BasicDependencyNode() = default;
+
+        // Registers the node as a dependent of a source node, ranking it after the source
+        void dependOn(BasicDependencyNode& source) {
+            {
+                WriteGuard<_lock> lock(source.mtx_);
+                source.dependents_.push_back(this);
+            }
+            sources_.push_back(&source);
+            rank_ = std::max(rank_, source.rank_ + 1);
+        }
+
+        void collectDependents(std::vector<DependencyNode*>& nodes) const override {
+            WriteGuard<_lock> lock(mtx_);
+            nodes.insert(nodes.end(), dependents_.begin(), dependents_.end());
+        }
+
+    private:
+        std::vector<BasicDependencyNode*> sources_;  // Nodes this node depends on
+        mutable _lock mtx_;  // Lock for thread safety of the dependents
+        std::vector<BasicDependencyNode*> dependents_;  // Nodes depending on this node
+    };
+
+} // namespace HKUltra
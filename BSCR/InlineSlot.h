@@ -0,0 +1,151 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace HKUltra {
+
+    /*
+    * InlineSlot is a type-erased callable with fixed inline storage, used as the slot type of InlineSignal.
+    * Unlike std::function it never allocates: the callable (a lambda, a functor or an object/member-function
+    * pair) is stored directly inside the slot, and a callable that does not fit is rejected at compile time.
+    * Trivially copyable callables, such as lambdas capturing pointers, are copied with a plain memcpy.
+    * The arguments are passed by const reference; a callable taking them by value receives its own copy.
+    */
+    template<typename... _args>
+    class InlineSlot {
+    public:
+        // Number of bytes available for the callable, enough for an object pointer and a member-function pointer
+        static constexpr std::size_t capacity = 4 * sizeof(void*);
+
+        // Default constructor: creates an empty slot
+        InlineSlot() noexcept = default;
+
+        /*
+        * Stores a copy of the callable inside the slot.
+        * The callable must fit in `capacity` bytes and be copyable, since signals copy their slots into snapshots.
+        */
+        template<typename _callable, typename = std::enable_if_t<
+            !std::is_same_v<std::decay_t<_callable>, InlineSlot> && std::is_invocable_v<std::decay_t<_callable>&, const _args&...>>>
+        InlineSlot(_callable&& callable) {
+            typedef std::decay_t<_callable> StoredType;
+            static_assert(sizeof(StoredType) <= capacity, "Callable is too large for InlineSlot.");
+            static_assert(alignof(StoredType) <= alignof(std::max_align_t), "Callable is over-aligned for InlineSlot.");
+            static_assert(std::is_copy_constructible_v<StoredType>, "InlineSlot requires a copyable callable.");
+            static_assert(std::is_nothrow_move_constructible_v<StoredType>, "InlineSlot requires a nothrow movable callable.");
+
+            ::new (static_cast<void*>(storage_)) StoredType(std::forward<_callable>(callable));
+            invoke_ = &invokeCallable<StoredType>;
+            manage_ = std::is_trivially_copyable_v<StoredType> ? nullptr : &manageCallable<StoredType>;  // Null means memcpy-able
+        }
+
+        /*
+        * Binds a member function to an object. The slot does not own the object.
+        */
+        template<typename _class, typename _method, typename = std::enable_if_t<std::is_member_function_pointer_v<_method>>>
+        InlineSlot(_class* object, _method method)
+            : InlineSlot([object, method](const _args&... args) { (object->*method)(args...); }) {
+        }
+
+        InlineSlot(const InlineSlot& other) {
+            copyFrom(other);
+        }
+
+        InlineSlot(InlineSlot&& other) noexcept {
+            moveFrom(other);
+        }
+
+        InlineSlot& operator=(const InlineSlot& rhs) {
+            if (this != &rhs) {  // Check for self-assignment
+                reset();
+                copyFrom(rhs);
+            }
+            return *this;
+        }
+
+        InlineSlot& operator=(InlineSlot&& rhs) noexcept {
+            if (this != &rhs) {  // Check for self-assignment
+                reset();
+                moveFrom(rhs);
+            }
+            return *this;
+        }
+
+        ~InlineSlot() {
+            reset();
+        }
+
+        // Calls the stored callable. The slot must not be empty.
+        void operator()(const _args&... args) const {
+            invoke_(storage_, args...);
+        }
+
+        // Returns true if the slot holds a callable
+        explicit operator bool() const noexcept {
+            return invoke_ != nullptr;
+        }
+
+    private:
+        enum class Operation { Copy, Move, Destroy };
+
+        alignas(std::max_align_t) mutable unsigned char storage_[capacity];  // Inline storage for the callable
+        void (*invoke_)(void* callable, const _args&... args) = nullptr;  // Calls the stored callable, null when empty
+        void (*manage_)(Operation operation, void* destination, void* source) = nullptr;  // Null for trivially copyable callables
+
+        template<typename _callable>
+        static void invokeCallable(void* callable, const _args&... args) {
+            (*static_cast<_callable*>(callable))(args...);
+        }
+
+        template<typename _callable>
+        static void manageCallable(Operation operation, void* destination, void* source) {
+            switch (operation) {
+            case Operation::Copy:
+                ::new (destination) _callable(*static_cast<const _callable*>(source));
+                break;
+            case Operation::Move:
+                ::new (destination) _callable(std::move(*static_cast<_callable*>(source)));
+                static_cast<_callable*>(source)->~_callable();
+                break;
+            case Operation::Destroy:
+                static_cast<_callable*>(destination)->~_callable();
+                break;
+            }
+        }
+
+        void copyFrom(const InlineSlot& other) {
+            if (other.manage_) {
+                other.manage_(Operation::Copy, storage_, other.storage_);
+            }
+            else if (other.invoke_) {
+                std::memcpy(storage_, other.storage_, capacity);
+            }
+            invoke_ = other.invoke_;
+            manage_ = other.manage_;
+        }
+
+        void moveFrom(InlineSlot& other) noexcept {
+            if (other.manage_) {
+                other.manage_(Operation::Move, storage_, other.storage_);
+            }
+            else if (other.invoke_) {
+                std::memcpy(storage_, other.storage_, capacity);
+            }
+            invoke_ = other.invoke_;
+            manage_ = other.manage_;
+            other.invoke_ = nullptr;  // The moved-from slot is left empty
+            other.manage_ = nullptr;
+        }
+
+        void reset() noexcept {
+            if (manage_) {
+                manage_(Operation::Destroy, storage_, nullptr);
+            }
+            invoke_ = nullptr;
+            manage_ = nullptr;
+        }
+    };
+
+}  // namespace HKUltra
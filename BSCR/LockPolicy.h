@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace HKUltra {
+
+    /*
+    * Lock policies select the synchronization used by Signal, Observable and ObservableValue.
+    * Any type meeting the standard Lockable requirements can be used; the following are provided:
+    *  - std::mutex: the default, blocking mutual exclusion;
+    *  - NullLock: no synchronization at all, for single-threaded builds;
+    *  - SpinLock: busy-waiting mutual exclusion, for short critical sections on real-time threads;
+    *  - SharedLock: a reader-writer lock, letting readers (getters, comparisons) run concurrently.
+    */
+
+    // NullLock performs no synchronization. Every operation compiles away.
+    struct NullLock {
+        void lock() noexcept {}
+        bool try_lock() noexcept { return true; }
+        void unlock() noexcept {}
+        void lock_shared() noexcept {}
+        bool try_lock_shared() noexcept { return true; }
+        void unlock_shared() noexcept {}
+    };
+
+    // SpinLock busy-waits until the lock is free, never yielding the thread to the scheduler.
+    class SpinLock {
+    public:
+        void lock() noexcept {
+            while (locked_.exchange(true, std::memory_order_acquire)) {
+                while (locked_.load(std::memory_order_relaxed)) {  // Spin on a plain load to keep the cache line shared
+                    pause();
+                }
+            }
+        }
+
+        bool try_lock() noexcept {
+            return !locked_.load(std::memory_order_relaxed) && !locked_.exchange(true, std::memory_order_acquire);
+        }
+
+        void unlock() noexcept {
+            locked_.store(false, std::memory_order_release);
+        }
+
+    private:
+        std::atomic<bool> locked_{ false };  // True while the lock is held
+
+        // Hints the processor that we are spinning
+        static void pause() noexcept {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+            _mm_pause();
+#endif
+        }
+    };
+
+    // SharedLock lets readers hold the lock concurrently while writers hold it exclusively.
+    typedef std::shared_mutex SharedLock;
+
+    // True if the lock policy supports shared (reader) locking
+    template <typename _lock>
+    inline constexpr bool is_shared_lock_v = requires(_lock& lock) {
+        lock.lock_shared();
+        lock.unlock_shared();
+    };
+
+    // ReadGuard takes a shared lock when the policy supports it, and an exclusive lock otherwise
+    template <typename _lock>
+    using ReadGuard = std::conditional_t<is_shared_lock_v<_lock>, std::shared_lock<_lock>, std::lock_guard<_lock>>;
+
+    // WriteGuard always takes an exclusive lock
+    template <typename _lock>
+    using WriteGuard = std::lock_guard<_lock>;
+
+} // namespace HKUltra
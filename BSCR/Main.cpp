@@ -1,33 +1,46 @@
+#include <atomic>
 #include <iostream>
+#include <string_view>
 #include <vector>
 #include <thread>
 #include <chrono>
 #include "ObservableValue.h"  // Assuming this header contains your ObservableValue class definition
 #include "Date.h"             // Assuming this header contains your Date class definition
+#include "DateFormatter.h"
 
 namespace HKUltra {
     // Observer Interface
-    class IObserver : public Observer<Date> {
+    class IObserver : public Observer<Date, ValueVersion> {
     public:
-        virtual void onNotify(Date date) = 0;
+        virtual void onNotify(const Date& date, const ValueVersion& version) = 0;
         virtual ~IObserver() = default;
     };
 
     // Concrete Observer
     class DateObserver : public IObserver {
     public:
-        void onNotify(Date date) override {
-            std::cout << "Date updated to: "
-                << date.year() << "-"
-                << date.month() << "-"
-                << date.day() << std::endl;
+        void onNotify(const Date& date, const ValueVersion& version) override {
+            // Notifications from concurrent threads may arrive out of order: skip those older than the last one shown
+            ValueVersion last = last_version_.load();
+            do {
+                if (version <= last) {
+                    return;
+                }
+            } while (!last_version_.compare_exchange_weak(last, version));
+            char text[10];  // Formatted without iostream number formatting, see DateFormatter.h
+            std::cout << "Date updated to: " << std::string_view(text, formatDate(date, text)) << " (version " << version << ")" << std::endl;
         }
+
+    private:
+        std::atomic<ValueVersion> last_version_{ 0 };  // Version of the last date shown
     };
 }
 
 int main() {
-    // Create an ObservableValue to hold the Date
-    HKUltra::ObservableValue<HKUltra::Date> observableDate(HKUltra::Date(HKUltra::Year(2023), std::chrono::month(1), std::chrono::day(1)));
+    using namespace HKUltra::literals;
+
+    // Create an ObservableValue to hold the Date, built at compile time from a date literal
+    HKUltra::ObservableValue<HKUltra::Date> observableDate("2023-01-01"_date);
 
     // Create multiple observers
     HKUltra::DateObserver observer1;
@@ -40,8 +53,8 @@ int main() {
     // Function to simulate changing the Date in a thread
     auto updateDate = [&observableDate](const HKUltra::Years& yearsToAdd) {
         //std::this_thread::sleep_for(std::chrono::seconds(1));  // Simulate work
-        HKUltra::Date newDate = observableDate.get();  // Get current date
-        observableDate.set(newDate + yearsToAdd);  // Update the date by adding years
+        // Read, add and write in one atomic step, so concurrent threads never overwrite each other's update
+        observableDate.update([&yearsToAdd](const HKUltra::Date& date) { return date + yearsToAdd; });
         };
 
     // Start multiple threads to update the date
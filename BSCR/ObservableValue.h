@@ -1,6 +1,13 @@
 #pragma once
 #include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+#include "DependencyNode.h"
 #include "Observable.h"  // Include the base Observable class
+#include "LockPolicy.h"
+#include "Transaction.h"
+#include "ValueStorage.h"
 
 namespace HKUltra {
 
@@ -8,21 +15,49 @@ namespace HKUltra {
     * ObservableValue is a specialization of the Observable class,
     * which allows a value of type _type to be observed.
     * The class provides methods to get and set the value, and it notifies
-    * all observers whenever the value changes.
+    * all observers whenever the value changes, with the new value and its version.
+    * Versions start at 1 and increase with each change. Notifications are delivered outside the locks, so with
+    * concurrent writers they may arrive out of order: observers skip stale deliveries by ignoring versions
+    * not greater than the last one they handled.
+    * The observer list is synchronized with the _lock policy (see LockPolicy.h). The value is held in the storage
+    * selected by ValueStorage (see ValueStorage.h): trivially copyable values, such as Date, are read without locking.
+    * An ObservableValue is also the root of the Computed values derived from it (see Computed.h): a change marks them
+    * dirty before the value is stored, and refreshes them after the observers are notified, in one propagation wave.
+    * The wave is opened within the writer critical section, once the value is known to change: setting the current
+    * value again leaves the Computed values untouched.
+    * Changes made within a Transaction (see Transaction.h) are buffered and notified together on commit.
     */
-    template<typename _type>
-    class ObservableValue : public Observable<_type> {
+    template<typename _type, typename _lock = std::mutex>
+    class ObservableValue : public BasicObservable<_lock, _type, ValueVersion>, public BasicDependencyNode<_lock> {
+        friend class Transaction;  // Allow transactions to store buffered values and notify once per observer
+
     public:
+        typedef ValueStorage<_type, _lock> StorageType;  // Alias for the storage of the value
+
         // Constructor to initialize the value, defaulting to the default constructor of _type
         ObservableValue(const _type& value = _type()) : value_(value) {}
 
+        // Destructor drops the value buffered for this ObservableValue by the transactions of the current thread
+        ~ObservableValue() {
+            Transaction::unstage(*this);
+        }
+
         /*
         * Getter for the current value of the observable.
         * Returns the current stored value.
         */
         _type get() const {
-            std::lock_guard<std::mutex> lock(mtx_);
-            return value_;  // Return the current value
+            return value_.load();  // Lock-free for trivially copyable values
+        }
+
+        // Returns the current value together with its version, read consistently
+        Versioned<_type> getVersioned() const {
+            return value_.loadVersioned();
+        }
+
+        // Returns the version of the current value
+        ValueVersion version() const {
+            return value_.version();
         }
 
         /*
@@ -30,21 +65,91 @@ namespace HKUltra {
         * If the new value is different from the current one, it updates the value
         * and notifies all observers about the change.
         * The method ensures that observers are only notified when the value actually changes.
+        * Within a transaction, the value is buffered until the transaction commits.
         */
         void set(const _type& value) {
-            // Only update and notify if the value has changed
-            {
-                std::lock_guard<std::mutex> lock(mtx_);  // Lock for thread safety during value update
-                if (value != value_) {
-                    value_ = value;  // Update the value
-                }
+            if (Transaction* transaction = Transaction::current()) {
+                transaction->stage(*this, value);
+                return;
+            }
+            Wave wave;
+            if (const ValueVersion version = value_.store(value, beginChange(wave))) {  // Zero if the value has not changed
+                publish(wave, value, version);  // Notify all observers about the value change, by reference
+            }
+        }
+
+        /*
+        * Atomically replaces the value with function(value), and notifies the observers once with the result
+        * if it differs from the previous value.
+        * Unlike get() followed by set(), concurrent updates are never lost.
+        * The function runs under the writer lock: it must be short and must not call back into this value.
+        * Returns the new value.
+        * Throws std::logic_error within a transaction, where the value it reads could be overwritten by the commit.
+        */
+        template <typename _function>
+        _type update(_function function) {
+            checkNoTransaction();
+            Wave wave;
+            const Versioned<_type> result = value_.update(function, beginChange(wave));
+            if (result.version) {
+                publish(wave, result.value, result.version);
+            }
+            return result.value;
+        }
+
+        /*
+        * Atomically replaces the value with `desired` if it equals `expected`, and notifies the observers once
+        * if the value changed. Returns true if `expected` matched.
+        * Throws std::logic_error within a transaction, like update().
+        */
+        bool compareAndSet(const _type& expected, const _type& desired) {
+            checkNoTransaction();
+            Wave wave;
+            ValueVersion version = 0;
+            if (!value_.compareExchange(expected, desired, version, beginChange(wave))) {
+                return false;
             }
-            this->notifyObservers(value_);  // Notify all observers about the value change
+            if (version) {
+                publish(wave, desired, version);
+            }
+            return true;
         }
 
     private:
-        mutable std::mutex mtx_;
-        _type value_;     // The value being observed
+        typedef DependencyNode::Wave Wave;  // Alias for the propagation wave of a change
+
+        StorageType value_;  // The value being observed
+
+        // Returns the write hook adding this value to the propagation wave of a change, just before it is stored
+        auto beginChange(Wave& wave) {
+            return [this, &wave] { wave.add(*this); };
+        }
+
+        // Notifies the observers of a stored change, and propagates it to the Computed values depending on this value
+        void publish(Wave& wave, const _type& value, ValueVersion version) {
+            wave.settle();
+            this->notifyObservers(value, version);
+            wave.refresh();
+        }
+
+        // Read-modify-write operations cannot be buffered, since their result depends on the committed value
+        static void checkNoTransaction() {
+            if (Transaction::current()) {
+                throw std::logic_error("update() and compareAndSet() cannot run within a transaction.");
+            }
+        }
+
+        /*
+        * Notifies the observers not in `notified` yet, and adds them to it. Observers are identified by their
+        * ObserverType subobject, so an object observing values of different types is notified once per type.
+        */
+        void notifyOnce(const _type& value, ValueVersion version, std::unordered_set<const void*>& notified) {
+            this->forEachObserver([&](typename ObservableValue::ObserverType* observer) {
+                if (notified.insert(static_cast<const void*>(observer)).second) {
+                    observer->onNotify(value, version);
+                }
+                });
+        }
     };
 
 }
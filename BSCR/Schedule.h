@@ -0,0 +1,270 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include "Calendar.h"
+#include "Date.h"
+#include "DateLookup.h"
+#include "DateVector.h"
+#include "LockPolicy.h"
+
+namespace HKUltra {
+
+    // Direction in which schedule dates are generated, which decides where the stub lands
+    enum class DateGenerationRule {
+        Forward,   // From the start date: the stub, if any, is at the end
+        Backward   // From the end date: the stub, if any, is at the start
+    };
+
+    // Length of the stub period when the tenor does not divide the schedule
+    enum class StubType {
+        Short,  // The stub is shorter than the tenor
+        Long    // The stub is merged with the adjacent period, making it longer than the tenor
+    };
+
+    /*
+    * ScheduleParameters describes a schedule. Two schedules with equal parameters have the same dates as long as
+    * the calendar is not changed, which is why ScheduleCache keys on the revision of the calendar rather than its address.
+    */
+    struct ScheduleParameters {
+        Date start;  // Effective date
+        Date end;  // Termination date
+        Months tenor{ 12 };  // Length of the regular periods
+        DateGenerationRule rule = DateGenerationRule::Backward;
+        StubType stub = StubType::Short;
+        bool end_of_month = false;  // Roll on month ends when the anchor date is a month end
+        BusinessDayConvention convention = BusinessDayConvention::Unadjusted;
+        const Calendar* calendar = nullptr;  // Calendar adjusting the dates, required unless the convention is Unadjusted
+
+        bool operator==(const ScheduleParameters& rhs) const = default;
+    };
+
+    // Hash of schedule parameters, combining all of their fields
+    struct ScheduleParametersHash {
+        std::size_t operator()(const ScheduleParameters& parameters) const {
+            std::uint64_t hash = 14695981039346656037ull;  // FNV-1a over the fields
+            auto combine = [&hash](std::uint64_t value) {
+                hash = (hash ^ value) * 1099511628211ull;
+            };
+            combine(std::uint32_t(parameters.start.serialNumber()));
+            combine(std::uint32_t(parameters.end.serialNumber()));
+            combine(std::uint64_t(parameters.tenor.count()));
+            combine(std::uint64_t(parameters.rule) | std::uint64_t(parameters.stub) << 8 | std::uint64_t(parameters.end_of_month) << 16 | std::uint64_t(parameters.convention) << 24);
+            combine(std::uint64_t(reinterpret_cast<std::uintptr_t>(parameters.calendar)));
+            return std::size_t(hash);
+        }
+    };
+
+    namespace ScheduleGeneration {
+
+        // Returns true if a date is the last day of its month
+        inline bool isEndOfMonth(const Date& date) {
+            return (date + Days(1)).day() == Day(1);
+        }
+
+        // Returns the last day of the month of a date
+        inline Date endOfMonth(const Date& date) {
+            return Date(DateLookup::monthEnd(date.serialNumber()));
+        }
+
+        // Returns the anchor shifted by a number of tenors, rolling on month ends if requested
+        inline Date roll(const Date& anchor, const Months& offset, bool end_of_month) {
+            const Date date = anchor + offset;  // Shift from the anchor rather than step by step, so the day of month never drifts
+            return end_of_month ? endOfMonth(date) : date;
+        }
+
+    } // namespace ScheduleGeneration
+
+    /*
+    * Generates the dates of a schedule, from the start date to the end date included, into a DateVector
+    * allocated once. Dates are computed from the anchor date (the start date going forward, the end date going backward)
+    * by whole numbers of tenors, then adjusted with the business-day convention; adjacent dates adjusted to the
+    * same business day are merged into one.
+    * Throws std::invalid_argument if the end date is not after the start date, the tenor is not positive,
+    * or the start and end dates adjust to the same business day.
+    */
+    inline DateVector generateSchedule(const ScheduleParameters& parameters) {
+        using namespace ScheduleGeneration;
+        const Date& start = parameters.start;
+        const Date& end = parameters.end;
+        if (!(start < end) || parameters.tenor.count() <= 0) {
+            throw std::invalid_argument("Invalid schedule parameters.");
+        }
+        if (parameters.convention != BusinessDayConvention::Unadjusted && !parameters.calendar) {
+            throw std::invalid_argument("A calendar is required to adjust schedule dates.");
+        }
+
+        // Upper bound of the number of dates, so the vector is allocated once
+        const std::int32_t months = (int(end.year()) - int(start.year())) * 12 + (int(unsigned(end.month())) - int(unsigned(start.month())));
+        const std::size_t capacity = std::size_t(months / parameters.tenor.count()) + 3;
+        DateVector dates(capacity);
+        std::size_t size = 0;
+
+        if (parameters.rule == DateGenerationRule::Forward) {
+            const bool end_of_month = parameters.end_of_month && isEndOfMonth(start);
+            dates.set(size++, start);
+            Date date = start;
+            for (std::int32_t period = 1;; ++period) {
+                date = roll(start, Months(period * parameters.tenor.count()), end_of_month);
+                if (!(date < end)) {
+                    break;
+                }
+                dates.set(size++, date);
+            }
+            dates.set(size++, end);
+            const bool has_stub = date != end;  // The first date past the last period does not fall on the end date
+            if (has_stub && parameters.stub == StubType::Long && size > 2) {
+                dates.set(size - 2, end);  // Merge the final stub with the previous period
+                --size;
+            }
+        }
+        else {
+            // Generate from the end, filling the vector from its back, then move the dates to the front
+            const bool end_of_month = parameters.end_of_month && isEndOfMonth(end);
+            std::size_t first = capacity;
+            dates.set(--first, end);
+            Date date = end;
+            for (std::int32_t period = 1;; ++period) {
+                date = roll(end, Months(-period * parameters.tenor.count()), end_of_month);
+                if (!(start < date)) {
+                    break;
+                }
+                dates.set(--first, date);
+            }
+            dates.set(--first, start);
+            const bool has_stub = date != start;  // The first date before the first period does not fall on the start date
+            if (has_stub && parameters.stub == StubType::Long && capacity - first > 2) {
+                dates.set(first + 1, start);  // Merge the initial stub with the next period
+                ++first;
+            }
+            for (std::size_t i = first; i < capacity; ++i) {
+                dates.set(size++, dates[i]);
+            }
+        }
+        dates.resize(size);
+
+        if (parameters.convention != BusinessDayConvention::Unadjusted) {
+            // Dates a day or two apart, as around a short stub, can adjust to the same business day: keep it once,
+            // so that no period is empty
+            std::size_t adjusted = 0;
+            for (std::size_t i = 0; i < size; ++i) {
+                const Date date = parameters.calendar->adjust(dates[i], parameters.convention);
+                if (adjusted == 0 || date != dates[adjusted - 1]) {
+                    dates.set(adjusted++, date);
+                }
+            }
+            if (adjusted < 2) {
+                throw std::invalid_argument("The schedule is empty once adjusted.");
+            }
+            dates.resize(adjusted);
+        }
+        return dates;
+    }
+
+    /*
+    * ScheduleCache shares the schedules generated for identical parameters: each distinct schedule is generated once,
+    * and every caller asking for it receives the same immutable DateVector.
+    * The calendar is part of the key through its revision (see Calendar::revision), so a schedule is generated again
+    * once its calendar gains or loses a holiday, and a calendar allocated at the address of a destroyed one never
+    * receives its schedules. The cache holds at most `capacity` schedules, evicting the oldest ones first, which also
+    * retires the schedules of outdated calendar revisions.
+    * Lookups are synchronized with the _lock policy (see LockPolicy.h); with SharedLock, lookups of cached schedules
+    * run concurrently, since they never update the eviction order.
+    */
+    template <typename _lock = std::mutex>
+    class ScheduleCache {
+    public:
+        typedef std::shared_ptr<const DateVector> ScheduleType;  // Alias for a shared, immutable schedule
+
+        // Default maximum number of cached schedules
+        static constexpr std::size_t default_capacity = 4096;
+
+        /*
+        * Constructor: creates an empty cache holding at most `capacity` schedules.
+        * Throws std::invalid_argument if the capacity is zero.
+        */
+        explicit ScheduleCache(std::size_t capacity = default_capacity) : capacity_(capacity) {
+            if (capacity_ == 0) {
+                throw std::invalid_argument("Schedule cache capacity must be positive.");
+            }
+        }
+
+        // Returns the schedule of the parameters, generating it on the first request
+        ScheduleType get(const ScheduleParameters& parameters) {
+            const Key key = keyOf(parameters);
+            {
+                ReadGuard<_lock> lock(mtx_);
+                auto it = schedules_.find(key);
+                if (it != schedules_.end()) {
+                    return it->second;
+                }
+            }
+            // Generate outside the lock; if another thread generated it meanwhile, keep the first one
+            ScheduleType schedule = std::make_shared<const DateVector>(generateSchedule(parameters));
+            WriteGuard<_lock> lock(mtx_);
+            auto [it, inserted] = schedules_.try_emplace(key, std::move(schedule));
+            if (inserted) {
+                order_.push_back(key);
+                while (order_.size() > capacity_) {  // Never evicts the new schedule, which is the newest
+                    schedules_.erase(order_.front());
+                    order_.pop_front();
+                }
+            }
+            return it->second;
+        }
+
+        // Maximum number of cached schedules
+        std::size_t capacity() const {
+            return capacity_;
+        }
+
+        // Number of cached schedules
+        std::size_t size() const {
+            ReadGuard<_lock> lock(mtx_);
+            return schedules_.size();
+        }
+
+        // Removes all cached schedules. Schedules still held by callers stay valid.
+        void clear() {
+            WriteGuard<_lock> lock(mtx_);
+            schedules_.clear();
+            order_.clear();
+        }
+
+    private:
+        // Cache key: the parameters without the calendar address, and the revision of the calendar (0 if unused)
+        struct Key {
+            ScheduleParameters parameters;
+            std::uint64_t calendar_revision;
+
+            bool operator==(const Key& rhs) const = default;
+        };
+
+        struct KeyHash {
+            std::size_t operator()(const Key& key) const {
+                return ScheduleParametersHash()(key.parameters) ^ std::size_t(key.calendar_revision * 0x9E3779B97F4A7C15ull);
+            }
+        };
+
+        std::size_t capacity_;  // Maximum number of cached schedules
+        mutable _lock mtx_;  // Lock for thread safety
+        std::unordered_map<Key, ScheduleType, KeyHash> schedules_;  // Schedules by key
+        std::deque<Key> order_;  // Keys of the cached schedules, oldest first
+
+        // Returns the key of the parameters. The calendar only matters when dates are adjusted
+        static Key keyOf(const ScheduleParameters& parameters) {
+            Key key{ parameters, 0 };
+            if (parameters.convention != BusinessDayConvention::Unadjusted && parameters.calendar) {
+                key.calendar_revision = parameters.calendar->revision();
+            }
+            key.parameters.calendar = nullptr;
+            return key;
+        }
+    };
+
+} // namespace HKUltra
@@ -4,87 +4,171 @@
 #include <mutex>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include "InlineSlot.h"
+#include "LockPolicy.h"
+#include "SnapshotList.h"
 
 namespace HKUltra {
 
     /*
-    * Signal class represents a mechanism for notifying a list of connected functions (slots).
+    * Connection is a handle to a slot connected to a Signal.
+    * It holds the stable index of the slot in the signal's slot map and the generation of that index
+    * at connection time, so a handle to a slot that has since been disconnected (and whose index may
+    * have been reused by another slot) is detected with a single comparison.
+    */
+    struct Connection {
+        static constexpr std::uint32_t invalid_index = 0xFFFFFFFFu;  // Index of a handle that was never connected
+
+        std::uint32_t index = invalid_index;  // Stable index of the slot in the signal's slot map
+        std::uint32_t generation = 0;  // Generation of the index when the slot was connected
+
+        bool operator==(const Connection& rhs) const = default;
+    };
+
+    /*
+    * BasicSignal class represents a mechanism for notifying a list of connected functions (slots).
     * It is used to connect, disconnect, and emit signals to those functions.
-    * The class does not manage the lifetime of the connected functions (slots), and it's up to the user
-    * to ensure that they are valid when emitting the signal.
+    * The slot type (_slot) is a policy: Signal stores std::function slots, while InlineSignal stores
+    * InlineSlot slots, which never allocate and are copied into snapshots without touching the heap.
+    * The signal owns the connected functions (slots) until they are disconnected, but not the objects
+    * they refer to; it's up to the user to ensure that those are valid when emitting the signal.
+    *
+    * Slots are kept in a generational slot map: the slots themselves live in the array iterated by emitters
+    * (see SnapshotList.h), and a sparse array of indices maps each Connection to its position in that array.
+    * Connecting appends the slot to the array and disconnecting marks it as erased, both in O(1) amortized:
+    * the array is only rebuilt, copying the live slots, when it is full or mostly made of erased slots.
+    * The order in which slots are called is unspecified.
+    *
+    * Emitters only register with their thread's reader counter and load the current array, and never hold the
+    * mutex while slots run, so slots may freely connect or disconnect on the same signal. A rebuilt array reuses
+    * the storage of a retired one once no emission can still hold it.
+    *
+    * Writers are synchronized with the _lock policy (see LockPolicy.h). With NullLock the signal is meant for
+    * a single thread, and emissions skip the bookkeeping that lets disconnect wait for other threads.
     */
-    template<typename... _args>
-    class Signal {
+    template<typename _slot, typename _lock, typename... _args>
+    class BasicSignal {
     public:
-        // SlotType is a function signature that represents the connected function (slot)
-        // It accepts a variable number of arguments (_args...) and returns void.
-        typedef std::function<void(_args...)> SlotType;
+        // SlotType is the connected function (slot)
+        // It accepts a variable number of arguments (_args...) by const reference and returns void.
+        // A slot that needs ownership of the arguments may take them by value, paying for its own copy.
+        typedef _slot SlotType;
+
+        // ConnectionType is the handle returned by connect, used later to disconnect the slot.
+        typedef Connection ConnectionType;
 
-        // ConnectionType is a shared pointer to a SlotType, representing a connection
-        // to a particular function (slot).
-        typedef std::shared_ptr<SlotType> ConnectionType;
+        // Constructor: starts with an empty published snapshot
+        BasicSignal() = default;
 
         /*
-        * Connects a slot (function) to the signal. The function is wrapped in a shared_ptr
-        * so that the signal can maintain a reference to it. Returns a ConnectionType to manage
-        * the connection, which can be used later to disconnect the slot.
+        * Connects a slot (function) to the signal.
+        * Returns a ConnectionType to manage the connection, which can be used later to disconnect the slot.
         */
         ConnectionType connect(SlotType slot) {
-            // Create a shared pointer to the slot
-            ConnectionType connection = std::make_shared<SlotType>(std::move(slot));
+            WriteGuard<_lock> lock(mtx_);  // Serializes writers, emitters are not blocked
 
-            {   // Lock for thread safety: ensures that no other thread modifies the connection list while we're adding to it
-                std::lock_guard<std::mutex> lock(mtx_);
-                connections_.push_back(connection);  // Add the connection to the list
+            // Reuse a freed index if possible, keeping the generation it was left with
+            std::uint32_t index;
+            if (!free_indices_.empty()) {
+                index = free_indices_.back();
+                free_indices_.pop_back();
             }
+            else {
+                index = static_cast<std::uint32_t>(indices_.size());
+                indices_.push_back(IndexEntry{});
+            }
+
+            indices_[index].position = slots_.insert(std::move(slot), index, relocator());  // Visible to the next emissions
 
-            return connection; // Return the connection to the caller for potential future disconnection
+            return ConnectionType{ index, indices_[index].generation };
         }
 
         /*
-        * Disconnects a slot (function) from the signal. The connection is identified by the
-        * ConnectionType returned when the slot was originally connected.
+        * Connects a member function of an object to the signal. The signal does not own the object.
         */
-        void disconnect(ConnectionType connection) {
-            {   // Lock for thread safety: prevents concurrent access/modification of the connection list
-                std::lock_guard<std::mutex> lock(mtx_);
+        template<typename _class, typename _method>
+        ConnectionType connect(_class* object, _method method) {
+            return connect(SlotType([object, method](const _args&... args) { (object->*method)(args...); }));
+        }
 
-                // Condition to check if a weak pointer's locked reference matches the connection
-                auto condition = [&connection](const std::weak_ptr<SlotType>& weak_connection) {
-                    return weak_connection.lock() == connection;  // Check if the weak pointer matches the shared pointer
-                    };
+        /*
+        * Disconnects a slot (function) from the signal in O(1) amortized. The connection is identified by the
+        * ConnectionType returned when the slot was originally connected; stale handles are ignored.
+        * Once disconnect returns, no emission can still invoke the slot, unless disconnect is
+        * called from within a slot or a notification, of this or any other signal or observable
+        * (waiting could then deadlock, so emissions already running on other threads may still
+        * invoke it once).
+        */
+        void disconnect(ConnectionType connection) {
+            {   // Lock for thread safety: serializes writers, emitters are not blocked
+                WriteGuard<_lock> lock(mtx_);
+                if (!isConnected(connection)) {
+                    return;  // Never connected, or already disconnected
+                }
 
-                // Erase the connection from the list if the condition is true
-                connections_.erase(std::remove_if(connections_.begin(), connections_.end(), condition), connections_.end());
+                slots_.erase(indices_[connection.index].position, relocator());  // Running emissions skip it from now on
+                ++indices_[connection.index].generation;  // Invalidate every outstanding handle to this index
+                free_indices_.push_back(connection.index);
             }
+            slots_.waitForReaders();
+        }
+
+        /*
+        * Returns true if the connection still refers to a slot connected to this signal.
+        */
+        bool connected(ConnectionType connection) const {
+            ReadGuard<_lock> lock(mtx_);
+            return isConnected(connection);
         }
 
         /*
         * Emits a signal to all connected slots, passing the provided arguments (_args...).
-        * Each connected slot will be called with the arguments provided.
-        * If a slot has been disconnected or its shared pointer expired, it will be removed from the list.
+        * Each connected slot will be called with references to the arguments provided, so the cost of
+        * an emission does not depend on the size of the arguments.
+        * The slots are called without holding any lock. Slots connected during the emission are not called,
+        * and slots disconnected during the emission are not called if it has not reached them yet.
         */
-        void emit(_args... args) {
-            {   // Lock for thread safety: prevents other threads from modifying the connection list while emitting the signal
-                std::lock_guard<std::mutex> lock(mtx_);
-
-                // Condition to check if a weak pointer is still valid (i.e., the slot has not been destroyed)
-                auto condition = [&](const std::weak_ptr<SlotType>& weak_connection) {
-                    if (auto connection = weak_connection.lock()) {  // If the slot is still valid (i.e., shared_ptr is still alive)
-                        (*connection)(args...);  // Call the slot (function) with the arguments
-                        return false;  // Keep the connection in the list (we do not remove it just yet)
-                    }
-                    return true;  // If the slot is no longer valid, mark it for removal
-                    };
-
-                // Remove invalid connections (expired or disconnected slots)
-                connections_.erase(std::remove_if(connections_.begin(), connections_.end(), condition), connections_.end());
+        void emit(const _args&... args) {
+            typename SlotListType::ReadScope scope(slots_);  // Mark this thread as emitting and take the current slots
+
+            for (const auto& slot : scope) {
+                slot(args...);  // Call the slot (function) with the arguments
             }
         }
 
     private:
-        mutable std::mutex mtx_;  // Mutex to ensure thread safety when modifying the connections list
-        std::vector<std::weak_ptr<SlotType>> connections_;  // List of weak pointers to the connected slots (functions)
+        typedef SnapshotList<SlotType, _lock> SlotListType;
+
+        // IndexEntry maps a stable slot index to its position in the slot array
+        struct IndexEntry {
+            std::uint32_t position = 0;  // Position of the slot in slots_ while connected
+            std::uint32_t generation = 0;  // Incremented every time the index is freed
+        };
+
+        mutable _lock mtx_;  // Lock serializing writers
+        SlotListType slots_;  // Connected slots, keyed by their index and iterated by emitters
+        std::vector<IndexEntry> indices_;  // Sparse array of stable indices
+        std::vector<std::uint32_t> free_indices_;  // Indices available for reuse
+
+        // Returns the callback updating the position of a slot when the slot array is rebuilt
+        auto relocator() {
+            return [this](std::uint32_t index, std::uint32_t position) { indices_[index].position = position; };
+        }
+
+        // Returns true if the connection refers to a connected slot. Must be called with the mutex held.
+        bool isConnected(ConnectionType connection) const {
+            // Freeing an index bumps its generation, so a matching generation means the slot is still connected
+            return connection.index < indices_.size() && indices_[connection.index].generation == connection.generation;
+        }
     };
 
-}  // namespace HKUltra
\ No newline at end of file
+    // Signal stores its slots in std::function, accepting callables of any size
+    template<typename... _args>
+    using Signal = BasicSignal<std::function<void(const _args&...)>, std::mutex, _args...>;
+
+    // InlineSignal stores its slots in InlineSlot: no allocation per connection and no atomic operation per slot on emission
+    template<typename... _args>
+    using InlineSignal = BasicSignal<InlineSlot<_args...>, std::mutex, _args...>;
+
+}  // namespace HKUltra
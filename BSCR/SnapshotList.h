@@ -0,0 +1,396 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "LockPolicy.h"
+
+namespace HKUltra {
+
+    /*
+    * SnapshotList publishes a list of elements to readers, who iterate it without taking any lock.
+    * It carries the emission path of Signal and the notification path of Observable.
+    * The elements live in an append-only snapshot: writers, serialized by the lock of their owner, insert() an element
+    * by constructing it past the published size and then publishing the new size, and erase() one by clearing its
+    * alive flag, so readers skip it from then on. Both are O(1). Each element carries a key identifying its owner
+    * (a slot index, a subscription), and keeps its position until the snapshot is rebuilt.
+    * A snapshot is rebuilt, copying only the live elements, when it is full or when removed elements outnumber the
+    * live ones; the owner is then told the new position of each key. Rebuilds cost O(live elements), so insert and
+    * erase remain O(1) amortized. The replaced snapshot is retired, and its storage is reused once no reader can hold
+    * it anymore. Readers open a ReadScope, which registers with a reader counter, loads the current snapshot and its
+    * size, and iterates the live elements among them.
+    *
+    * Reader counters are sharded by thread, each shard on its own cache line, so concurrent readers never write to
+    * the same memory; readers do not touch any reference count either. Writers track running readers with a phase
+    * (epoch): a retired snapshot is reclaimed once the phase has advanced twice since it was retired, which requires
+    * every reader started before it to have finished. Writers advance the phase without waiting, whenever they insert or erase.
+    * A writer removing an element calls waitForReaders() once its lock is released, so that no reader can still be using
+    * it. The wait is skipped on threads reading any list, since two such threads waiting for each other would deadlock.
+    * With NullLock the list is meant for a single thread, and readers only maintain a plain counter.
+    */
+    class SnapshotListBase {
+    protected:
+        static inline thread_local std::uint32_t open_scopes_ = 0;  // Number of read scopes open on the thread, over all lists
+    };
+
+    template <typename _element, typename _lock, typename _key = std::uint32_t>
+    class SnapshotList : SnapshotListBase {
+        struct Entry;
+        struct Snapshot;
+
+    public:
+        typedef std::uint32_t Position;  // Position of an element in the current snapshot
+
+        SnapshotList() = default;
+
+        SnapshotList(const SnapshotList&) = delete;
+        SnapshotList& operator=(const SnapshotList&) = delete;
+
+        // Destructor: no reader can still be running, so every snapshot is reclaimed
+        ~SnapshotList() {
+            delete snapshot_.load();
+            for (Snapshot* snapshot : retired_) {
+                delete snapshot;
+            }
+            delete spare_;
+        }
+
+        /*
+        * Iterator walks the live elements of a snapshot, skipping those erased before it reaches them.
+        */
+        class Iterator {
+        public:
+            Iterator(const Entry* entry, const Entry* last) : entry_(entry), last_(last) {
+                skipErased();
+            }
+
+            const _element& operator*() const {
+                return entry_->element;
+            }
+
+            Iterator& operator++() {
+                ++entry_;
+                skipErased();
+                return *this;
+            }
+
+            bool operator!=(const Iterator& rhs) const {
+                return entry_ != rhs.entry_;
+            }
+
+        private:
+            const Entry* entry_;  // Current entry
+            const Entry* last_;  // End of the entries published when the iteration started
+
+            void skipErased() {
+                while (entry_ != last_ && !entry_->alive.load(std::memory_order_acquire)) {
+                    ++entry_;
+                }
+            }
+        };
+
+        /*
+        * ReadScope registers a reader with the list for its lifetime, which keeps the snapshot it took from being reclaimed.
+        * It is also counted as open on its thread, so that a writer running within a reader knows not to wait.
+        */
+        class ReadScope {
+        public:
+            explicit ReadScope(SnapshotList& list)
+                : list_(list), counter_(list.enterReader()) {
+                snapshot_ = list_.snapshot_.load();  // Taken after registering, so the writer retiring it sees this reader
+                size_ = snapshot_ ? snapshot_->size.load(std::memory_order_acquire) : 0;  // Elements inserted later are not iterated
+                ++open_scopes_;
+            }
+
+            ~ReadScope() {
+                --open_scopes_;
+                list_.leaveReader(counter_);
+            }
+
+            ReadScope(const ReadScope&) = delete;
+            ReadScope& operator=(const ReadScope&) = delete;
+
+            // Iterators over the live elements of the snapshot
+            Iterator begin() const {
+                const Entry* first = snapshot_ ? snapshot_->entries.get() : nullptr;
+                return Iterator(first, first + size_);
+            }
+
+            Iterator end() const {
+                const Entry* last = (snapshot_ ? snapshot_->entries.get() : nullptr) + size_;
+                return Iterator(last, last);
+            }
+
+        private:
+            SnapshotList& list_;  // List being read
+            std::atomic<std::int32_t>* counter_;  // Reader counter this scope is registered with
+            const Snapshot* snapshot_;  // Snapshot being iterated
+            Position size_;  // Number of entries of the snapshot published when the scope opened
+        };
+
+        /*
+        * Inserts an element in O(1) amortized and returns its position. If the snapshot has to be rebuilt first,
+        * relocate(key, position) is called for each element already in the list.
+        * Must be called with the writers' lock held.
+        */
+        template <typename _relocate>
+        Position insert(_element element, const _key& key, _relocate&& relocate) {
+            Snapshot* snapshot = snapshot_.load(std::memory_order_relaxed);
+            if (!snapshot || keys_.size() == snapshot->capacity) {
+                snapshot = rebuild(live_ + 1, relocate);
+            }
+            const Position position = Position(keys_.size());
+            Entry& entry = snapshot->entries[position];
+            entry.element = std::move(element);  // Past the published size: no reader can see it yet
+            entry.alive.store(true, std::memory_order_relaxed);
+            keys_.push_back(key);
+            ++live_;
+            snapshot->size.store(position + 1, std::memory_order_release);  // Publishes the entry to new readers
+            return position;
+        }
+
+        /*
+        * Erases the element at a position in O(1) amortized: readers skip it from then on, and it is destroyed when its
+        * snapshot is reclaimed. If the snapshot is compacted, relocate(key, position) is called for each remaining element.
+        * Must be called with the writers' lock held.
+        */
+        template <typename _relocate>
+        void erase(Position position, _relocate&& relocate) {
+            Snapshot* snapshot = snapshot_.load(std::memory_order_relaxed);
+            snapshot->entries[position].alive.store(false, std::memory_order_release);
+            --live_;
+            if (2 * live_ < keys_.size()) {  // Erased elements outnumber the live ones
+                rebuild(live_, relocate);
+            }
+            else {
+                reclaim();
+            }
+        }
+
+        // Returns the number of live elements. Must be called with the writers' lock held.
+        Position size() const {
+            return live_;
+        }
+
+        // Calls function(key) for every live element. Must be called with the writers' lock held.
+        template <typename _function>
+        void forEachKey(_function&& function) const {
+            const Snapshot* snapshot = snapshot_.load(std::memory_order_relaxed);
+            for (Position position = 0; position < keys_.size(); ++position) {
+                if (snapshot->entries[position].alive.load(std::memory_order_relaxed)) {
+                    function(keys_[position]);
+                }
+            }
+        }
+
+        /*
+        * Blocks until every read scope opened before the call has closed.
+        * Skipped when the calling thread is reading any list: it would wait for itself if it reads this one, and could
+        * wait forever for another thread reading this list and waiting for a list this thread reads. Readers already
+        * running on other threads may then still use the removed elements once; the elements themselves are only
+        * destroyed once no reader can hold them, whether or not anyone waited.
+        */
+        void waitForReaders() {
+            if constexpr (!is_synchronized) {
+                return;  // Single-threaded: no reader can be running on another thread
+            }
+            if (open_scopes_ != 0) {
+                return;  // Called from within a reader: waiting could deadlock
+            }
+
+            const std::uint32_t target = phase_.load() + 2;  // Two advances drain every reader registered so far
+            while (std::int32_t(phase_.load() - target) < 0) {
+                if (!tryAdvance()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+    private:
+        // True unless the list is restricted to a single thread by the NullLock policy
+        static constexpr bool is_synchronized = !std::is_same_v<_lock, NullLock>;
+
+        // Number of reader counter shards: one is enough for a single thread
+        static constexpr std::size_t shard_count = is_synchronized ? 8 : 1;
+
+        // Capacity of the smallest snapshot
+        static constexpr Position min_capacity = 4;
+
+        // Entry holds an element, constructed before it is published and left untouched until its snapshot is reclaimed
+        struct Entry {
+            _element element{};  // Element iterated by readers
+            std::atomic<bool> alive{ false };  // Cleared when the element is erased
+        };
+
+        // Snapshot holds the entries published to readers
+        struct Snapshot {
+            explicit Snapshot(Position capacity) : entries(new Entry[capacity]), capacity(capacity) {}
+
+            std::unique_ptr<Entry[]> entries;  // Entries, of which the first `size` are published
+            Position capacity;  // Number of entries allocated
+            std::atomic<Position> size{ 0 };  // Number of entries published to readers
+            std::uint32_t phase = 0;  // Phase in which the snapshot was retired
+        };
+
+        // Shard holds the reader counters of the threads mapped to it, alone on its cache line
+        struct alignas(64) Shard {
+            std::atomic<std::int32_t> readers[2] = {};  // Number of running readers per phase parity
+        };
+
+        std::atomic<Snapshot*> snapshot_{ nullptr };  // Currently published snapshot, if any
+        std::vector<_key> keys_;  // Key of each entry of the current snapshot, guarded by the writers' lock
+        Position live_ = 0;  // Number of live entries in the current snapshot, guarded by the writers' lock
+        std::vector<Snapshot*> retired_;  // Snapshots replaced while readers may still iterate them, guarded by the writers' lock
+        Snapshot* spare_ = nullptr;  // Reclaimed snapshot whose storage is reused by the next rebuild
+
+        std::atomic<std::uint32_t> phase_{ 0 };  // Selects the reader counter new readers register with
+        Shard shards_[shard_count];  // Reader counters, sharded by thread
+
+        // Returns the shard of the calling thread, assigned round-robin when the thread first reads any list
+        Shard& shard() {
+            static std::atomic<std::size_t> next_shard{ 0 };
+            static thread_local const std::size_t index = next_shard.fetch_add(1, std::memory_order_relaxed);
+            return shards_[index % shard_count];
+        }
+
+        /*
+        * Registers a starting reader with its shard's counter for the current phase and returns that counter.
+        */
+        std::atomic<std::int32_t>* enterReader() {
+            if constexpr (!is_synchronized) {
+                std::atomic<std::int32_t>* counter = &shards_[0].readers[0];
+                counter->store(counter->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return counter;
+            }
+            Shard& own = shard();
+            for (;;) {
+                const std::uint32_t phase = phase_.load();
+                own.readers[phase & 1].fetch_add(1);
+                if (phase_.load() == phase) {
+                    return &own.readers[phase & 1];  // Registered before any writer advanced the phase
+                }
+                own.readers[phase & 1].fetch_sub(1);  // Raced with an advance: register with the new phase instead
+            }
+        }
+
+        // Unregisters a finished reader
+        void leaveReader(std::atomic<std::int32_t>* counter) {
+            if constexpr (!is_synchronized) {
+                counter->store(counter->load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+                return;
+            }
+            counter->fetch_sub(1);
+        }
+
+        /*
+        * Advances the phase if no reader registered two phases ago is still running, and returns true if it did.
+        * Safe to call concurrently: only one of the callers racing on the same phase advances it.
+        */
+        bool tryAdvance() {
+            std::uint32_t phase = phase_.load();
+            for (const Shard& shard : shards_) {
+                if (shard.readers[(phase + 1) & 1].load() != 0) {  // Same parity as the readers of phase - 1
+                    return false;
+                }
+            }
+            phase_.compare_exchange_strong(phase, phase + 1);
+            return true;
+        }
+
+        // Returns an empty snapshot of at least the given capacity, reusing the spare one if it is large enough
+        Snapshot* acquire(Position capacity) {
+            Snapshot* snapshot = spare_;
+            spare_ = nullptr;
+            if (!snapshot || snapshot->capacity < capacity) {
+                delete snapshot;
+                snapshot = new Snapshot(std::max(min_capacity, capacity));
+            }
+            return snapshot;
+        }
+
+        /*
+        * Copies the live entries into a new snapshot with room for at least `required` elements and publishes it,
+        * calling relocate(key, position) for each of them. Returns the new snapshot.
+        */
+        template <typename _relocate>
+        Snapshot* rebuild(Position required, _relocate& relocate) {
+            Snapshot* snapshot = acquire(2 * required);  // Leaves room for as many insertions as the copy costs
+            const Snapshot* current = snapshot_.load(std::memory_order_relaxed);
+            Position size = 0;
+            for (Position position = 0; position < keys_.size(); ++position) {
+                const Entry& entry = current->entries[position];
+                if (entry.alive.load(std::memory_order_relaxed)) {
+                    snapshot->entries[size].element = entry.element;  // Copied: readers may still be using the original
+                    snapshot->entries[size].alive.store(true, std::memory_order_relaxed);
+                    keys_[size] = keys_[position];
+                    relocate(keys_[size], size);
+                    ++size;
+                }
+            }
+            keys_.resize(size);
+            snapshot->size.store(size, std::memory_order_relaxed);
+            replace(snapshot);
+            return snapshot;
+        }
+
+        // Publishes a snapshot to readers and retires the previous one
+        void replace(Snapshot* snapshot) {
+            Snapshot* retired = snapshot_.exchange(snapshot);  // Releases the entries to new readers
+            if (retired) {
+                retired->phase = phase_.load();  // Readers that can hold it registered no later than this phase
+                retired_.push_back(retired);
+            }
+            reclaim();
+        }
+
+        /*
+        * Reclaims the retired snapshots no reader can hold anymore, keeping one as spare storage.
+        * Never waits for readers. Must be called with the writers' lock held.
+        */
+        void reclaim() {
+            if (retired_.empty()) {
+                return;
+            }
+            if constexpr (is_synchronized) {
+                tryAdvance();
+                tryAdvance();
+            }
+            else if (shards_[0].readers[0].load(std::memory_order_relaxed) != 0) {
+                return;  // Still iterating on this thread
+            }
+
+            const std::uint32_t phase = phase_.load();
+            auto reclaimable = [&](const Snapshot* snapshot) {
+                return !is_synchronized || std::int32_t(phase - snapshot->phase) >= 2;  // Every reader that could hold it has finished
+            };
+            for (Snapshot*& snapshot : retired_) {
+                if (reclaimable(snapshot)) {
+                    clear(*snapshot);  // Releases the elements now rather than on reuse
+                    if (!spare_) {
+                        spare_ = snapshot;
+                    }
+                    else {
+                        delete snapshot;
+                    }
+                    snapshot = nullptr;
+                }
+            }
+            retired_.erase(std::remove(retired_.begin(), retired_.end(), nullptr), retired_.end());
+        }
+
+        // Destroys the elements of a snapshot no reader can hold, leaving it empty
+        static void clear(Snapshot& snapshot) {
+            const Position size = snapshot.size.load(std::memory_order_relaxed);
+            for (Position position = 0; position < size; ++position) {
+                snapshot.entries[position].element = _element{};
+                snapshot.entries[position].alive.store(false, std::memory_order_relaxed);
+            }
+            snapshot.size.store(0, std::memory_order_relaxed);
+        }
+    };
+
+} // namespace HKUltra
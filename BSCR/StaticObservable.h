@@ -0,0 +1,63 @@
+#pragma once
+
+#include <mutex>
+#include "Subscription.h"
+
+namespace HKUltra {
+
+    /*
+    * StaticallyNotifiable is satisfied by observer types that provide onNotify(const _args&...).
+    */
+    template <typename _observer, typename... _args>
+    concept StaticallyNotifiable = requires(_observer& observer, const _args&... args) {
+        observer.onNotify(args...);
+    };
+
+    /*
+    * BasicStaticObservable class is the statically dispatched counterpart of BasicObservable.
+    * It only accepts observers of one known type (_derived) and calls their onNotify method directly,
+    * without virtual calls, so notifications can be inlined by the compiler.
+    */
+    template <typename _lock, typename _derived, typename... _args>
+    class BasicStaticObservable;
+
+    /*
+    * BasicStaticObserver class is the statically dispatched counterpart of BasicObserver, based on CRTP.
+    * A class derives from StaticObserver<itself, _args...> and provides a non-virtual
+    * onNotify(const _args&...) method; it keeps the registerWith/unregisterWith ergonomics of Observer.
+    */
+    template <typename _lock, typename _derived, typename... _args>
+    class BasicStaticObserver : public ObserverBase<BasicStaticObservable<_lock, _derived, _args...>, _derived> {
+    public:
+        typedef BasicStaticObservable<_lock, _derived, _args...> ObservableType;  // Alias for the Observable type the observer is listening to
+
+    protected:
+        // Only derived classes can be observers
+        BasicStaticObserver() = default;
+    };
+
+    template <typename _lock, typename _derived, typename... _args>
+    class BasicStaticObservable : public ObservableBase<BasicStaticObservable<_lock, _derived, _args...>, _derived, _lock> {
+    public:
+        typedef BasicStaticObserver<_lock, _derived, _args...> ObserverType;  // Alias for the Observer type
+
+        /*
+        * Notifies all registered observers by calling their onNotify method directly.
+        */
+        void notifyObservers(const _args&... args) {
+            static_assert(StaticallyNotifiable<_derived, _args...>, "StaticObserver requires a onNotify(const _args&...) method.");
+
+            this->forEachObserver([&](_derived* observer) {
+                observer->onNotify(args...);  // Direct, inlinable call
+                });
+        }
+    };
+
+    // StaticObservable and StaticObserver use the default std::mutex lock policy
+    template <typename _derived, typename... _args>
+    using StaticObservable = BasicStaticObservable<std::mutex, _derived, _args...>;
+
+    template <typename _derived, typename... _args>
+    using StaticObserver = BasicStaticObserver<std::mutex, _derived, _args...>;
+
+} // namespace HKUltra
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "LockPolicy.h"
+#include "SnapshotList.h"
+
+namespace HKUltra {
+
+    /*
+    * Subscription is an intrusive node linking one observer to one observable.
+    * Each node is linked into the observer's doubly linked list of observables and into a bucket of the observable's
+    * hash index of observers, and holds its position in the observable's array of observers (its back-link),
+    * so registering and unregistering are O(1) amortized and never allocate once the pool and the array have warmed up.
+    */
+    template <typename _observable, typename _observer>
+    struct Subscription {
+        _observable* observable = nullptr;  // Observable side of the subscription
+        _observer* observer = nullptr;  // Observer side of the subscription
+        std::uint32_t position = 0;  // Position of the observer in the observable's array of observers
+        Subscription* next_in_bucket = nullptr;  // Next subscription in the same bucket of the observable's index
+        Subscription* previous_observable = nullptr;  // Links in the observer's list of observables
+        Subscription* next_observable = nullptr;
+    };
+
+    /*
+    * IntrusiveList is a doubly linked list threaded through the link members (_previous, _next) of its nodes.
+    * It does not own its nodes.
+    */
+    template <typename _node, _node* _node::* _previous, _node* _node::* _next>
+    class IntrusiveList {
+    public:
+        // Returns the first node of the list, or null if the list is empty
+        _node* front() const {
+            return head_;
+        }
+
+        // Returns the node following `node` in the list, or null
+        static _node* next(const _node* node) {
+            return node->*_next;
+        }
+
+        // Links a node at the front of the list in O(1)
+        void pushFront(_node* node) {
+            node->*_previous = nullptr;
+            node->*_next = head_;
+            if (head_) {
+                head_->*_previous = node;
+            }
+            head_ = node;
+        }
+
+        // Unlinks a node from the list in O(1)
+        void erase(_node* node) {
+            if (node->*_previous) {
+                node->*_previous->*_next = node->*_next;
+            }
+            else {
+                head_ = node->*_next;
+            }
+            if (node->*_next) {
+                node->*_next->*_previous = node->*_previous;
+            }
+            node->*_previous = nullptr;
+            node->*_next = nullptr;
+        }
+
+    private:
+        _node* head_ = nullptr;  // First node of the list
+    };
+
+    /*
+    * SubscriptionPool recycles subscription nodes through a free list and allocates them in blocks,
+    * so that registering an observer does not allocate once the pool has warmed up.
+    * The pool is shared by all observables using the node type, whatever their lock policy: observables used on
+    * separate threads under NullLock still share it, so it is always synchronized with a std::mutex. The mutex is
+    * only taken when a subscription is created or removed, never on notifications.
+    */
+    template <typename _node>
+    class SubscriptionPool {
+    public:
+        // Returns a default-initialized node
+        static _node* acquire() {
+            SubscriptionPool& pool = instance();
+            std::lock_guard<std::mutex> lock(pool.mtx_);
+            if (!pool.free_) {
+                pool.grow();
+            }
+            _node* node = pool.free_;
+            pool.free_ = node->next_in_bucket;
+            *node = _node{};
+            return node;
+        }
+
+        // Returns a node to the pool
+        static void release(_node* node) {
+            SubscriptionPool& pool = instance();
+            std::lock_guard<std::mutex> lock(pool.mtx_);
+            node->next_in_bucket = pool.free_;  // Free nodes are chained through their bucket links
+            pool.free_ = node;
+        }
+
+    private:
+        static constexpr std::size_t block_size = 256;  // Number of nodes allocated at once
+
+        std::mutex mtx_;  // Mutex for thread safety when taking or returning nodes
+        _node* free_ = nullptr;  // Head of the free list
+        std::vector<std::unique_ptr<_node[]>> blocks_;  // Blocks of nodes owned by the pool
+
+        // The pool is intentionally never destroyed, so observers with static storage can still release their nodes
+        static SubscriptionPool& instance() {
+            static SubscriptionPool* pool = new SubscriptionPool();
+            return *pool;
+        }
+
+        // Allocates a new block of nodes and chains them into the free list. Must be called with the mutex held.
+        void grow() {
+            blocks_.push_back(std::make_unique<_node[]>(block_size));
+            _node* block = blocks_.back().get();
+            for (std::size_t i = 0; i < block_size; ++i) {
+                block[i].next_in_bucket = free_;
+                free_ = &block[i];
+            }
+        }
+    };
+
+    template <typename _observable, typename _observer, typename _lock>
+    class ObservableBase;
+
+    /*
+    * ObserverBase holds the observer side of the subscriptions: the intrusive list of the observables
+    * it is registered with. _observable is the observable type it can register with, and _observer is the
+    * most derived type observables dispatch notifications to.
+    * An observer's subscriptions must be managed (registered, unregistered, destroyed) from one thread at a time.
+    * The destructor unregisters the observer once its derived parts are already destroyed: an observer notified from
+    * other threads must unregister before it starts being destroyed.
+    */
+    template <typename _observable, typename _observer>
+    class ObserverBase {
+        template <typename, typename, typename>
+        friend class ObservableBase;  // Allow observables to link subscriptions into the observer's list
+
+    public:
+        typedef _observable ObservableType;  // Alias for the Observable type the observer is listening to
+        typedef Subscription<_observable, ObserverBase> SubscriptionType;  // Alias for the subscription node type
+
+        ObserverBase(const ObserverBase&) = delete;
+        ObserverBase& operator=(const ObserverBase&) = delete;
+
+        // Destructor unsubscribes from all observables by walking the list of subscriptions
+        ~ObserverBase() {
+            while (SubscriptionType* subscription = subscriptions_.front()) {
+                subscription->observable->detach(subscription);
+            }
+        }
+
+        /*
+        * Registers this observer with an observable in O(1) amortized, making it start receiving notifications.
+        * Registering twice with the same observable has no effect.
+        */
+        void registerWith(ObservableType& observable) {
+            observable.attach(this);
+        }
+
+        /*
+        * Unregisters this observer from an observable in O(1) amortized, so it will no longer receive notifications.
+        */
+        void unregisterWith(ObservableType& observable) {
+            observable.detach(this);
+        }
+
+    protected:
+        ObserverBase() = default;
+
+    private:
+        typedef IntrusiveList<SubscriptionType, &SubscriptionType::previous_observable, &SubscriptionType::next_observable> SubscriptionListType;
+
+        SubscriptionListType subscriptions_;  // Subscriptions to all observables this observer is registered with
+    };
+
+    /*
+    * ObservableBase holds the observable side of the subscriptions: the array of the registered observers, keyed by
+    * their subscription, and a hash index of the subscriptions by observer, chained through the subscription nodes.
+    * Registering appends the observer to the array and unregistering marks it as erased, both in O(1) amortized
+    * (see SnapshotList.h); the subscription tracks the position of its observer as the array is rebuilt.
+    * Derived classes notify observers through forEachObserver, which iterates the array without holding the lock:
+    * observers may register or unregister with this or any other observable from within a notification, and
+    * notifications on other threads never wait for them. Running notifications skip the observers unregistered
+    * before they reach them.
+    * Once an unregistration returns, no notification can still reach the observer, unless it is made from within a
+    * notification or a signal emission, of this or any other observable or signal: waiting for other threads could then
+    * deadlock, so notifications already running on them may still reach it once. An observer notified from other
+    * threads must therefore not be destroyed from within a notification.
+    * Registrations are synchronized with the _lock policy.
+    */
+    template <typename _observable, typename _observer, typename _lock>
+    class ObservableBase {
+        friend class ObserverBase<_observable, _observer>;  // Allow observers to register and unregister themselves
+
+    public:
+        typedef ObserverBase<_observable, _observer> ObserverBaseType;  // Alias for the observer bookkeeping type
+        typedef typename ObserverBaseType::SubscriptionType SubscriptionType;  // Alias for the subscription node type
+
+        ObservableBase(const ObservableBase&) = delete;
+        ObservableBase& operator=(const ObservableBase&) = delete;
+
+        // Destructor unsubscribes all observers, so they never refer to a destroyed observable
+        ~ObservableBase() {
+            WriteGuard<_lock> lock(mtx_);
+            observers_.forEachKey([](SubscriptionType* subscription) {
+                subscription->observer->subscriptions_.erase(subscription);
+                PoolType::release(subscription);
+                });
+        }
+
+        // Returns true if at least one observer is registered
+        bool hasObservers() const {
+            ReadGuard<_lock> lock(mtx_);
+            return observers_.size() != 0;
+        }
+
+    protected:
+        ObservableBase() = default;
+
+        /*
+        * Calls function(_observer*) for every observer registered when the call starts, without holding the lock.
+        * Observers unregistered during the call are skipped if the call has not reached them yet.
+        */
+        template <typename _function>
+        void forEachObserver(_function&& function) {
+            typename ObserverListType::ReadScope scope(observers_);
+            for (_observer* observer : scope) {
+                function(observer);
+            }
+        }
+
+    private:
+        typedef SubscriptionPool<SubscriptionType> PoolType;
+        typedef SnapshotList<_observer*, _lock, SubscriptionType*> ObserverListType;
+
+        static constexpr std::size_t min_buckets = 8;  // Number of buckets of the index once an observer registers
+
+        mutable _lock mtx_;  // Lock for thread safety of the registrations
+        ObserverListType observers_;  // Registered observers, keyed by their subscription and iterated by notifications
+        std::vector<SubscriptionType*> buckets_;  // Hash index of the subscriptions by observer, a power of two in size
+
+        // Registers an observer in O(1) amortized, ignoring duplicate registrations
+        void attach(ObserverBaseType* observer) {
+            WriteGuard<_lock> lock(mtx_);
+            if (find(observer)) {
+                return;  // Only add the observer if it hasn't been registered yet
+            }
+            SubscriptionType* subscription = PoolType::acquire();
+            subscription->observable = static_cast<_observable*>(this);
+            subscription->observer = observer;
+            observer->subscriptions_.pushFront(subscription);
+            index(subscription);
+            subscription->position = observers_.insert(static_cast<_observer*>(observer), subscription, relocate);  // Visible to the next notifications
+        }
+
+        // Unregisters an observer in O(1) amortized if it is registered
+        void detach(ObserverBaseType* observer) {
+            {
+                WriteGuard<_lock> lock(mtx_);
+                SubscriptionType* subscription = find(observer);
+                if (!subscription) {
+                    return;
+                }
+                unlink(subscription);
+            }
+            observers_.waitForReaders();
+        }
+
+        // Unregisters the observer of a subscription in O(1) amortized
+        void detach(SubscriptionType* subscription) {
+            {
+                WriteGuard<_lock> lock(mtx_);
+                unlink(subscription);
+            }
+            observers_.waitForReaders();
+        }
+
+        /*
+        * Unlinks a subscription from the observer's list, the index and the array of observers, where running
+        * notifications skip it from now on. Must be called with the mutex held.
+        */
+        void unlink(SubscriptionType* subscription) {
+            subscription->observer->subscriptions_.erase(subscription);
+            unindex(subscription);
+            observers_.erase(subscription->position, relocate);
+            PoolType::release(subscription);
+        }
+
+        // Updates the position of an observer when the array of observers is rebuilt
+        static void relocate(SubscriptionType* subscription, std::uint32_t position) {
+            subscription->position = position;
+        }
+
+        // Returns the bucket of an observer in the index, which must not be empty
+        std::size_t bucket(const ObserverBaseType* observer) const {
+            // Fibonacci hashing: addresses are aligned, so their low bits alone would leave most buckets empty
+            const std::uint64_t hash = std::uint64_t(reinterpret_cast<std::uintptr_t>(observer)) * 0x9E3779B97F4A7C15ull;
+            return std::size_t(hash >> 32) & (buckets_.size() - 1);
+        }
+
+        // Returns the subscription of an observer to this observable, or null. Must be called with the mutex held.
+        SubscriptionType* find(const ObserverBaseType* observer) const {
+            if (buckets_.empty()) {
+                return nullptr;
+            }
+            SubscriptionType* subscription = buckets_[bucket(observer)];
+            while (subscription && subscription->observer != observer) {
+                subscription = subscription->next_in_bucket;
+            }
+            return subscription;
+        }
+
+        /*
+        * Adds a new subscription to the index, doubling the number of buckets when there are more subscriptions than
+        * buckets. Must be called with the mutex held, before the observer is inserted in the array of observers.
+        */
+        void index(SubscriptionType* subscription) {
+            if (observers_.size() < buckets_.size()) {
+                link(subscription);
+                return;
+            }
+            buckets_.assign(std::max(min_buckets, 2 * buckets_.size()), nullptr);
+            observers_.forEachKey([this](SubscriptionType* indexed) { link(indexed); });
+            link(subscription);
+        }
+
+        // Links a subscription at the front of its bucket. Must be called with the mutex held.
+        void link(SubscriptionType* subscription) {
+            SubscriptionType*& head = buckets_[bucket(subscription->observer)];
+            subscription->next_in_bucket = head;
+            head = subscription;
+        }
+
+        // Removes a subscription from the index. Must be called with the mutex held.
+        void unindex(SubscriptionType* subscription) {
+            SubscriptionType** link = &buckets_[bucket(subscription->observer)];
+            while (*link != subscription) {
+                link = &(*link)->next_in_bucket;
+            }
+            *link = subscription->next_in_bucket;
+        }
+    };
+
+} // namespace HKUltra
@@ -0,0 +1,219 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Date.h"
+#include "DateVector.h"
+
+namespace HKUltra {
+
+    /*
+    * TimeSeries holds values of type _type keyed by date, in two parallel contiguous arrays sorted by date:
+    * the serial numbers of the dates and the values.
+    * Searches use a copy of the serial numbers in Eytzinger (breadth-first) order: the first levels of the implicit
+    * tree share cache lines, and each step of the search is a comparison added to the index, without branches.
+    * Bulk lookups of sorted dates walk both arrays together (merge join); unsorted dates are searched one by one.
+    * A TimeSeries is not synchronized: it can be read concurrently, but must not be modified while being read.
+    * Values are exposed as spans of the contiguous array, so _type cannot be bool, which std::vector packs into bits:
+    * a series of flags holds them as std::uint8_t instead.
+    */
+    template <typename _type>
+    class TimeSeries {
+        static_assert(!std::is_same_v<_type, bool>, "TimeSeries<bool> cannot expose its values as a span: use std::uint8_t.");
+
+    public:
+        typedef Date::SerialType SerialType;  // Alias for the serial number type of the dates
+        typedef _type ValueType;  // Alias for the type of the values
+
+        // Dates and values of a part of the series
+        struct Range {
+            std::span<const SerialType> serial_numbers;
+            std::span<const _type> values;
+        };
+
+        // Default constructor: creates an empty series
+        TimeSeries() {
+            buildIndex();
+        }
+
+        /*
+        * Creates a series from dates and their values, in any order.
+        * Throws std::invalid_argument if the sizes differ or a date appears twice.
+        */
+        TimeSeries(const DateVector& dates, std::span<const _type> values) {
+            if (dates.size() != values.size()) {
+                throw std::invalid_argument("Dates and values must have the same size.");
+            }
+            std::vector<std::size_t> order(dates.size());
+            std::iota(order.begin(), order.end(), std::size_t(0));
+            const std::span<const SerialType> serial_numbers = dates.serialNumbers();
+            std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return serial_numbers[a] < serial_numbers[b]; });
+            serial_numbers_.reserve(order.size());
+            values_.reserve(order.size());
+            for (std::size_t i : order) {
+                if (!serial_numbers_.empty() && serial_numbers_.back() == serial_numbers[i]) {
+                    throw std::invalid_argument("Duplicate date in time series.");
+                }
+                serial_numbers_.push_back(serial_numbers[i]);
+                values_.push_back(values[i]);
+            }
+            buildIndex();
+        }
+
+        // Number of dates in the series
+        std::size_t size() const {
+            return serial_numbers_.size();
+        }
+
+        // Returns true if the series is empty
+        bool empty() const {
+            return serial_numbers_.empty();
+        }
+
+        // Returns the date at `index`, dates being sorted
+        Date date(std::size_t index) const {
+            return Date(serial_numbers_[index]);
+        }
+
+        // Returns the value at `index`
+        const _type& value(std::size_t index) const {
+            return values_[index];
+        }
+
+        // Sorted serial numbers of the dates
+        std::span<const SerialType> serialNumbers() const {
+            return serial_numbers_;
+        }
+
+        // Values, in the order of the dates
+        std::span<const _type> values() const {
+            return values_;
+        }
+
+        /*
+        * Sets the value of a date, inserting it if needed. Insertion is linear in the size of the series
+        * since the index is rebuilt: build large series with the constructor instead.
+        */
+        void set(const Date& date, const _type& value) {
+            const std::size_t index = lowerBound(date);
+            if (index < size() && serial_numbers_[index] == date.serialNumber()) {
+                values_[index] = value;
+                return;
+            }
+            serial_numbers_.insert(serial_numbers_.begin() + std::ptrdiff_t(index), date.serialNumber());
+            values_.insert(values_.begin() + std::ptrdiff_t(index), value);
+            buildIndex();
+        }
+
+        // Returns the index of the first date on or after `date`, or size() if there is none, without branches
+        std::size_t lowerBound(const Date& date) const {
+            const SerialType serial_number = date.serialNumber();
+            const std::size_t size = serial_numbers_.size();
+            std::size_t k = 1;
+            while (k <= size) {
+                k = 2 * k + std::size_t(eytzinger_[k] < serial_number);  // Go right if the node is before the date
+            }
+            k >>= std::countr_one(k) + 1;  // Undo the right turns taken after the last left turn
+            return ranks_[k];  // ranks_[0] is size()
+        }
+
+        // Returns the value of a date, or null if the series has no value on that date
+        const _type* find(const Date& date) const {
+            const std::size_t index = lowerBound(date);
+            return index < size() && serial_numbers_[index] == date.serialNumber() ? &values_[index] : nullptr;
+        }
+
+        // Returns the value of the last date on or before `date`, or null if the series starts after it
+        const _type* asOf(const Date& date) const {
+            const std::size_t index = lowerBound(date + Days(1));  // First date after `date`
+            return index > 0 ? &values_[index - 1] : nullptr;
+        }
+
+        // Returns the dates and values in [from, to)
+        Range range(const Date& from, const Date& to) const {
+            const std::size_t begin = lowerBound(from);
+            const std::size_t end = std::max(begin, lowerBound(to));
+            return Range{ std::span<const SerialType>(serial_numbers_).subspan(begin, end - begin),
+                std::span<const _type>(values_).subspan(begin, end - begin) };
+        }
+
+        /*
+        * Looks up the value of each date of a vector, writing `missing` when the series has no value on that date.
+        * `values` must have the size of `dates`.
+        */
+        void joinExact(const DateVector& dates, std::span<_type> values, const _type& missing) const {
+            join(dates, values, [&](std::size_t index, SerialType serial_number) -> const _type& {
+                return index < size() && serial_numbers_[index] == serial_number ? values_[index] : missing;
+            });
+        }
+
+        /*
+        * Looks up the as-of value (last date on or before) of each date of a vector, writing `missing` for dates before
+        * the series starts. `values` must have the size of `dates`.
+        */
+        void joinAsOf(const DateVector& dates, std::span<_type> values, const _type& missing) const {
+            join(dates, values, [&](std::size_t index, SerialType serial_number) -> const _type& {
+                // `index` is the first date on or after the date: step back unless it is the date itself
+                const bool exact = index < size() && serial_numbers_[index] == serial_number;
+                return exact ? values_[index] : (index > 0 ? values_[index - 1] : missing);
+            });
+        }
+
+    private:
+        std::vector<SerialType> serial_numbers_;  // Sorted serial numbers of the dates
+        std::vector<_type> values_;  // Values, in the order of the dates
+        std::vector<SerialType> eytzinger_;  // Serial numbers in Eytzinger order, from index 1
+        std::vector<std::size_t> ranks_;  // Sorted index of each Eytzinger node, ranks_[0] being size()
+
+        // Rebuilds the Eytzinger index from the sorted serial numbers
+        void buildIndex() {
+            eytzinger_.assign(serial_numbers_.size() + 1, 0);
+            ranks_.assign(serial_numbers_.size() + 1, serial_numbers_.size());
+            std::size_t next = 0;
+            fillIndex(1, next);
+        }
+
+        // Fills the subtree rooted at node k with the next sorted dates, in order
+        void fillIndex(std::size_t k, std::size_t& next) {
+            if (k <= serial_numbers_.size()) {
+                fillIndex(2 * k, next);
+                eytzinger_[k] = serial_numbers_[next];
+                ranks_[k] = next++;
+                fillIndex(2 * k + 1, next);
+            }
+        }
+
+        /*
+        * Calls pick(lower bound index, serial number) for each date. Sorted dates are merged with the series in a single
+        * linear pass; other dates are searched in the index.
+        */
+        template <typename _pick>
+        void join(const DateVector& dates, std::span<_type> values, _pick pick) const {
+            if (values.size() != dates.size()) {
+                throw std::invalid_argument("Dates and values must have the same size.");
+            }
+            const std::span<const SerialType> serial_numbers = dates.serialNumbers();
+            if (std::is_sorted(serial_numbers.begin(), serial_numbers.end())) {
+                std::size_t index = 0;
+                for (std::size_t i = 0; i < serial_numbers.size(); ++i) {
+                    while (index < size() && serial_numbers_[index] < serial_numbers[i]) {
+                        ++index;
+                    }
+                    values[i] = pick(index, serial_numbers[i]);
+                }
+            }
+            else {
+                for (std::size_t i = 0; i < serial_numbers.size(); ++i) {
+                    values[i] = pick(lowerBound(Date(serial_numbers[i])), serial_numbers[i]);
+                }
+            }
+        }
+    };
+
+} // namespace HKUltra
@@ -0,0 +1,209 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "DependencyNode.h"
+#include "ValueStorage.h"
+
+namespace HKUltra {
+
+    /*
+    * Transaction batches the changes of several ObservableValues made on one thread.
+    * While a transaction is open on a thread, ObservableValue::set() on that thread buffers the value instead of storing it;
+    * setting the same value several times keeps the last one. commit() then:
+    *  - stores every buffered value, so that observers see all of them from their first notification;
+    *  - notifies each changed value once, and each observer once per observer type, even if it watches several of
+    *    the changed values: it receives the first of them, in the order they were first set. While notified, it finds
+    *    which of the others changed with Transaction::committing()->changed(), and reads them with get();
+    *  - refreshes the Computed values depending on them in a single propagation wave (see DependencyNode).
+    * A transaction destroyed without being committed discards its buffered values. An ObservableValue destroyed while
+    * its value is buffered, or while the commit notifies, is dropped from the transactions of its thread; a value
+    * buffered by a transaction must not be destroyed on another thread before that transaction ends.
+    * get() returns the committed value while the transaction is open. update() and compareAndSet(), whose result
+    * depends on the committed value, throw std::logic_error. Transactions opened while another one is open join it:
+    * only the outermost one commits or discards.
+    */
+    class Transaction {
+    public:
+        // Opens a transaction on the current thread, or joins the open one
+        Transaction() {
+            if (!current_) {
+                current_ = this;
+            }
+        }
+
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+
+        // Closes the transaction, discarding the values not committed
+        ~Transaction() {
+            if (current_ == this) {
+                current_ = nullptr;
+            }
+        }
+
+        // Returns the transaction open on the current thread, or null
+        static Transaction* current() {
+            return current_;
+        }
+
+        // Returns the transaction whose commit is notifying observers on the current thread, or null
+        static const Transaction* committing() {
+            return committing_;
+        }
+
+        // Returns true if the commit changed a value. Valid from the time the transaction commits
+        bool changed(const DependencyNode& value) const {
+            return std::find(changed_.begin(), changed_.end(), &value) != changed_.end();
+        }
+
+        // Values changed by the commit, in the order they were first set
+        std::span<const DependencyNode* const> changedValues() const {
+            return changed_;
+        }
+
+        /*
+        * Stores the buffered values and notifies their observers, closing the transaction.
+        * Values set by the observers during the commit are stored immediately. Does nothing in a joined transaction.
+        */
+        void commit() {
+            if (current_ != this) {
+                return;
+            }
+            current_ = nullptr;
+            notifying_ = std::move(writes_);
+            writes_.clear();
+            index_.clear();
+            DependencyNode::Wave wave;  // Each changed value joins it just before it is stored
+            for (const std::unique_ptr<PendingWrite>& write : notifying_) {
+                if (!write->dropped && write->apply(wave)) {
+                    changed_.push_back(write->node());
+                }
+            }
+            wave.settle();
+
+            // Commits started by the observers are nested: restore the outer one once notified, even on exceptions
+            struct CommittingScope {
+                Transaction& transaction;
+
+                ~CommittingScope() {
+                    committing_ = transaction.outer_committing_;
+                    transaction.notifying_.clear();
+                }
+            } scope{ *this };
+            outer_committing_ = committing_;  // Read by the scope: set before anything can throw
+            committing_ = this;
+            std::unordered_set<const void*> notified;  // Observers notified so far, by ObserverType subobject
+            for (const std::unique_ptr<PendingWrite>& write : notifying_) {
+                if (!write->dropped) {  // Unless an observer destroyed the value meanwhile
+                    write->notify(notified);
+                }
+            }
+            wave.refresh();
+        }
+
+        /*
+        * Buffers a value for an ObservableValue. Called by ObservableValue::set().
+        */
+        template <typename _value, typename _type>
+        void stage(_value& target, const _type& value) {
+            auto it = index_.find(&target);
+            if (it != index_.end()) {
+                static_cast<Write<_value, _type>*>(it->second)->value = value;  // Keep the last value only
+                return;
+            }
+            std::unique_ptr<Write<_value, _type>> write = std::make_unique<Write<_value, _type>>(target, value);
+            index_.emplace(&target, write.get());
+            writes_.push_back(std::move(write));
+        }
+
+        /*
+        * Drops the value buffered for an ObservableValue being destroyed from the transactions open or committing on
+        * the current thread, so they never store it nor notify its observers. Called by ObservableValue's destructor.
+        */
+        template <typename _value>
+        static void unstage(const _value& target) {
+            if (current_) {
+                current_->drop(&target, &target);
+            }
+            for (Transaction* transaction = committing_; transaction; transaction = transaction->outer_committing_) {
+                transaction->drop(&target, &target);
+            }
+        }
+
+    private:
+        // PendingWrite is a value buffered for one ObservableValue
+        struct PendingWrite {
+            bool dropped = false;  // True once the ObservableValue is destroyed: the value is neither stored nor notified
+
+            virtual ~PendingWrite() = default;
+
+            // Stores the value, adding it to the wave if it changes. Returns true if it changed
+            virtual bool apply(DependencyNode::Wave& wave) = 0;
+
+            // Notifies the observers not notified yet, if the value changed
+            virtual void notify(std::unordered_set<const void*>& notified) = 0;
+
+            // Node of the ObservableValue in the dependency graph
+            virtual DependencyNode* node() = 0;
+
+            // Returns true if the value is buffered for an ObservableValue
+            virtual bool isFor(const void* target) const = 0;
+        };
+
+        template <typename _value, typename _type>
+        struct Write : PendingWrite {
+            _value& target;  // ObservableValue the value is for
+            _type value;  // Last value set
+            ValueVersion version = 0;  // Version stored by apply, 0 if the value did not change
+
+            Write(_value& observable, const _type& buffered) : target(observable), value(buffered) {}
+
+            bool apply(DependencyNode::Wave& wave) override {
+                version = target.value_.store(value, target.beginChange(wave));
+                return version != 0;
+            }
+
+            void notify(std::unordered_set<const void*>& notified) override {
+                if (version) {
+                    target.notifyOnce(value, version, notified);
+                }
+            }
+
+            DependencyNode* node() override {
+                return &target;
+            }
+
+            bool isFor(const void* observable) const override {
+                return static_cast<const void*>(&target) == observable;
+            }
+        };
+
+        inline static thread_local Transaction* current_ = nullptr;  // Transaction open on the thread, if any
+        inline static thread_local Transaction* committing_ = nullptr;  // Transaction notifying on the thread, if any
+        std::vector<std::unique_ptr<PendingWrite>> writes_;  // Buffered values, in the order they were first set
+        std::vector<std::unique_ptr<PendingWrite>> notifying_;  // Values being stored and notified by commit()
+        Transaction* outer_committing_ = nullptr;  // Transaction whose commit was notifying when this one started notifying
+        std::unordered_map<const void*, PendingWrite*> index_;  // Buffered values by ObservableValue
+        std::vector<const DependencyNode*> changed_;  // Values changed by the commit, in the order they were first set
+
+        // Marks the value buffered for an ObservableValue as dropped, whether it is still buffered or being committed
+        void drop(const void* target, const DependencyNode* node) {
+            auto it = index_.find(target);
+            if (it != index_.end()) {
+                it->second->dropped = true;
+                index_.erase(it);  // A new value at the same address starts a new write
+            }
+            for (const std::unique_ptr<PendingWrite>& write : notifying_) {
+                if (!write->dropped && write->isFor(target)) {
+                    write->dropped = true;
+                }
+            }
+            changed_.erase(std::remove(changed_.begin(), changed_.end(), node), changed_.end());
+        }
+    };
+
+} // namespace HKUltra
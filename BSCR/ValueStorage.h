@@ -0,0 +1,242 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include "LockPolicy.h"
+
+namespace HKUltra {
+
+    /*
+    * Value storages hold the value of an ObservableValue. They are selected at compile time by ValueStorage:
+    *  - SeqLockValue for trivially copyable types: readers take no lock and never block writers;
+    *  - LockedValue for other types, and with NullLock, where there is nothing to synchronize.
+    * Both store a value only if it differs from the current one (operator!=), and count the changes in a version:
+    * the initial value has version 1, and each change increments it. Writes return the new version, or 0 if the value
+    * did not change. Read-modify-write operations (update, compareExchange) run in a single writer critical section,
+    * so concurrent writers never lose updates.
+    * Writes take an optional hook, called within the writer critical section just before a changed value is written,
+    * and never when the value does not change: ObservableValue uses it to open its propagation wave.
+    */
+
+    // Version of a value, incremented on each change
+    typedef std::uint64_t ValueVersion;
+
+    // A value read together with its version
+    template <typename _type>
+    struct Versioned {
+        _type value;
+        ValueVersion version;
+    };
+
+    // NoWriteHook is the default hook of the writes: it does nothing
+    struct NoWriteHook {
+        void operator()() const noexcept {}
+    };
+
+    // LockedValue guards the value with the _lock policy: readers share it when the policy allows it
+    template <typename _type, typename _lock>
+    class LockedValue {
+    public:
+        explicit LockedValue(const _type& value) : value_(value) {}
+
+        // Returns a copy of the value
+        _type load() const {
+            ReadGuard<_lock> lock(mtx_);
+            return value_;
+        }
+
+        // Returns a copy of the value and its version
+        Versioned<_type> loadVersioned() const {
+            ReadGuard<_lock> lock(mtx_);
+            return Versioned<_type>{ value_, version_ };
+        }
+
+        // Returns the version of the value
+        ValueVersion version() const {
+            ReadGuard<_lock> lock(mtx_);
+            return version_;
+        }
+
+        // Replaces the value if the new one differs. Returns the new version, or 0 if the value did not change
+        template <typename _hook = NoWriteHook>
+        ValueVersion store(const _type& value, _hook hook = _hook()) {
+            WriteGuard<_lock> lock(mtx_);
+            return write(value, hook);
+        }
+
+        // Replaces the value with function(value). Returns the new value and version, 0 if the value did not change
+        template <typename _function, typename _hook = NoWriteHook>
+        Versioned<_type> update(_function function, _hook hook = _hook()) {
+            WriteGuard<_lock> lock(mtx_);
+            _type value = function(static_cast<const _type&>(value_));
+            const ValueVersion version = write(value, hook);
+            return Versioned<_type>{ std::move(value), version };
+        }
+
+        /*
+        * Replaces the value with `desired` if it equals `expected`. Returns true if it did, and sets `version`
+        * to the new version, or 0 if the value did not change.
+        */
+        template <typename _hook = NoWriteHook>
+        bool compareExchange(const _type& expected, const _type& desired, ValueVersion& version, _hook hook = _hook()) {
+            WriteGuard<_lock> lock(mtx_);
+            version = 0;
+            if (value_ != expected) {
+                return false;
+            }
+            version = write(desired, hook);
+            return true;
+        }
+
+    private:
+        mutable _lock mtx_;  // Lock for thread safety
+        _type value_;  // Current value
+        ValueVersion version_ = 1;  // Number of values held so far
+
+        // Stores a value if it differs from the current one, under the writer lock
+        template <typename _hook>
+        ValueVersion write(const _type& value, _hook& hook) {
+            if (!(value != value_)) {
+                return 0;
+            }
+            hook();
+            value_ = value;
+            return ++version_;
+        }
+    };
+
+    /*
+    * SeqLockValue stores a trivially copyable value as atomic words guarded by a sequence counter (a seqlock).
+    * Writers are serialized by the _lock policy; each write makes the counter odd, copies the words, and makes it even again.
+    * Readers copy the words between two reads of the counter and retry if a write overlapped, so they never lock:
+    * a read costs two loads of the counter plus one load per word, and only retries while a write is in progress.
+    */
+    template <typename _type, typename _lock>
+    class SeqLockValue {
+        static_assert(std::is_trivially_copyable_v<_type>, "SeqLockValue requires a trivially copyable type.");
+
+    public:
+        explicit SeqLockValue(const _type& value) {
+            NoWriteHook hook;
+            write(value, hook);
+        }
+
+        // Returns a copy of the value, without locking
+        _type load() const {
+            return loadVersioned().value;
+        }
+
+        // Returns a copy of the value and its version, read consistently without locking
+        Versioned<_type> loadVersioned() const {
+            std::array<std::uint64_t, word_count> buffer;
+            std::uint64_t sequence;
+            while (true) {
+                sequence = sequence_.load(std::memory_order_acquire);
+                if (sequence & 1) {
+                    continue;  // A write is in progress
+                }
+                for (std::size_t i = 0; i < word_count; ++i) {
+                    buffer[i] = words_[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);  // Order the copy before the second read of the counter
+                if (sequence_.load(std::memory_order_relaxed) == sequence) {
+                    break;
+                }
+            }
+            return Versioned<_type>{ fromWords(buffer), sequence / 2 };
+        }
+
+        // Returns the version of the value, without locking
+        ValueVersion version() const {
+            return sequence_.load(std::memory_order_acquire) / 2;  // Version of the last complete write
+        }
+
+        // Replaces the value if the new one differs. Returns the new version, or 0 if the value did not change
+        template <typename _hook = NoWriteHook>
+        ValueVersion store(const _type& value, _hook hook = _hook()) {
+            WriteGuard<_lock> lock(mtx_);
+            return value != current() ? write(value, hook) : 0;
+        }
+
+        /*
+        * Replaces the value with function(value). Returns the new value and version, 0 if the value did not change.
+        * Readers are not blocked meanwhile.
+        */
+        template <typename _function, typename _hook = NoWriteHook>
+        Versioned<_type> update(_function function, _hook hook = _hook()) {
+            WriteGuard<_lock> lock(mtx_);
+            const _type current_value = current();
+            const _type value = function(current_value);
+            return Versioned<_type>{ value, value != current_value ? write(value, hook) : 0 };
+        }
+
+        /*
+        * Replaces the value with `desired` if it equals `expected`. Returns true if it did, and sets `version`
+        * to the new version, or 0 if the value did not change.
+        */
+        template <typename _hook = NoWriteHook>
+        bool compareExchange(const _type& expected, const _type& desired, ValueVersion& version, _hook hook = _hook()) {
+            WriteGuard<_lock> lock(mtx_);
+            const _type current_value = current();
+            version = 0;
+            if (current_value != expected) {
+                return false;
+            }
+            version = desired != current_value ? write(desired, hook) : 0;
+            return true;
+        }
+
+    private:
+        static constexpr std::size_t word_count = (sizeof(_type) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        std::atomic<std::uint64_t> sequence_{ 0 };  // Twice the version when the words hold a complete value, odd during a write
+        std::array<std::atomic<std::uint64_t>, word_count> words_;  // Bytes of the value
+        _lock mtx_;  // Lock serializing writers
+
+        // Rebuilds a value from its words
+        static _type fromWords(const std::array<std::uint64_t, word_count>& buffer) {
+            _type value;
+            std::memcpy(static_cast<void*>(&value), buffer.data(), sizeof(_type));
+            return value;
+        }
+
+        // Returns the value; only called by the writer holding the lock, so no write can overlap
+        _type current() const {
+            std::array<std::uint64_t, word_count> buffer;
+            for (std::size_t i = 0; i < word_count; ++i) {
+                buffer[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            return fromWords(buffer);
+        }
+
+        // Calls the hook, then writes a value, making the counter odd for the duration of the copy. Returns the new version
+        template <typename _hook>
+        ValueVersion write(const _type& value, _hook& hook) {
+            hook();
+            std::array<std::uint64_t, word_count> buffer = {};
+            std::memcpy(buffer.data(), &value, sizeof(_type));
+            const std::uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+            sequence_.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);  // Order the odd counter before the copy
+            for (std::size_t i = 0; i < word_count; ++i) {
+                words_[i].store(buffer[i], std::memory_order_relaxed);
+            }
+            sequence_.store(sequence + 2, std::memory_order_release);
+            return (sequence + 2) / 2;
+        }
+    };
+
+    // True if values of type _type are stored in a SeqLockValue under the _lock policy
+    template <typename _type, typename _lock>
+    inline constexpr bool is_seqlock_storage_v = std::is_trivially_copyable_v<_type> && std::is_default_constructible_v<_type>
+        && !std::is_same_v<_lock, NullLock>;
+
+    // Storage of a value of type _type under the _lock policy
+    template <typename _type, typename _lock>
+    using ValueStorage = std::conditional_t<is_seqlock_storage_v<_type, _lock>, SeqLockValue<_type, _lock>, LockedValue<_type, _lock>>;
+
+} // namespace HKUltra
@@ -0,0 +1,126 @@
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include "Calendar.h"
+#include "Date.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+namespace {
+
+    // Counts the business days in [from, to) one day at a time
+    std::int32_t countBusinessDays(const Calendar& calendar, Date from, Date to) {
+        std::int32_t count = 0;
+        for (; from < to; from += Days(1)) {
+            count += calendar.isBusinessDay(from);
+        }
+        return count;
+    }
+
+    // Moves a date by business days one day at a time. Returns the first date outside the window if it is left
+    Date stepBusinessDays(const Calendar& calendar, Date date, std::int32_t business_days) {
+        const Days step(business_days < 0 ? -1 : 1);
+        for (std::int32_t remaining = business_days < 0 ? -business_days : business_days; remaining > 0;) {
+            date += step;
+            if (date < calendar.first() || date > calendar.last()) {
+                break;
+            }
+            remaining -= calendar.isBusinessDay(date);
+        }
+        return date;
+    }
+
+    // Calendar of 2024 with New Year's Day and Christmas as holidays, with a few days of margin
+    Calendar calendar2024() {
+        Calendar calendar("2023-12-20"_date, "2025-01-10"_date);
+        calendar.addHoliday("2024-01-01"_date);
+        calendar.addHoliday("2024-12-25"_date);
+        return calendar;
+    }
+
+} // namespace
+
+// Business days are the weekdays that are not holidays
+TEST_CASE(calendarBusinessDays) {
+    Calendar calendar = calendar2024();
+    bool matches = true;
+    for (Date date = calendar.first(); date <= calendar.last(); date += Days(1)) {
+        const std::chrono::weekday weekday{ std::chrono::sys_days(Days(date.serialNumber())) };
+        const bool holiday = weekday == std::chrono::Saturday || weekday == std::chrono::Sunday
+            || date == "2024-01-01"_date || date == "2024-12-25"_date;
+        matches = matches && calendar.isBusinessDay(date) == !holiday && calendar.isHoliday(date) == holiday;
+    }
+    CHECK(matches);
+    CHECK_THROWS(calendar.isBusinessDay("2025-01-11"_date), std::out_of_range);
+    CHECK_THROWS(Calendar("2024-01-02"_date, "2024-01-01"_date), std::invalid_argument);
+
+    calendar.removeHoliday("2024-01-06"_date);  // A Saturday worked
+    CHECK(calendar.isBusinessDay("2024-01-06"_date));
+}
+
+// Word-wide advance and counting agree with stepping one day at a time
+TEST_CASE(calendarAdvanceAndCount) {
+    const Calendar calendar = calendar2024();
+    bool advances = true;
+    bool out_of_range = true;
+    bool counts = true;
+    for (Date date = "2024-01-01"_date; date < "2024-12-31"_date; date += Days(5)) {
+        for (std::int32_t business_days : { -7, -1, 0, 1, 2, 45, 130 }) {
+            const Date expected = stepBusinessDays(calendar, date, business_days);
+            if (expected < calendar.first() || expected > calendar.last()) {
+                try {
+                    calendar.advance(date, business_days);
+                    out_of_range = false;
+                }
+                catch (const std::out_of_range&) {}
+                continue;
+            }
+            advances = advances && calendar.advance(date, business_days) == expected;
+        }
+        for (std::int32_t days : { 0, 1, 6, 63, 64, 65, 200 }) {
+            const Date to = date + Days(days);
+            if (to <= calendar.last()) {
+                counts = counts && calendar.businessDaysBetween(date, to) == countBusinessDays(calendar, date, to)
+                    && calendar.businessDaysBetween(to, date) == -countBusinessDays(calendar, date, to);
+            }
+        }
+    }
+    CHECK(advances);
+    CHECK(out_of_range);
+    CHECK(counts);
+
+    // The day after the window ends an interval covering the rest of it
+    const Date end = calendar.last() + Days(1);
+    CHECK(calendar.businessDaysBetween(calendar.first(), end) == countBusinessDays(calendar, calendar.first(), end));
+    CHECK(calendar.businessDaysBetween(end, end) == 0);
+    CHECK_THROWS(calendar.businessDaysBetween(calendar.first(), end + Days(1)), std::out_of_range);
+    CHECK_THROWS(calendar.advance("2025-01-08"_date, 5), std::out_of_range);
+
+    CHECK(calendar.adjust("2024-12-25"_date, BusinessDayConvention::Following) == "2024-12-26"_date);
+    CHECK(calendar.adjust("2024-08-31"_date, BusinessDayConvention::ModifiedFollowing) == "2024-08-30"_date);
+    CHECK(calendar.adjust("2024-06-01"_date, BusinessDayConvention::ModifiedPreceding) == "2024-06-03"_date);
+}
+
+// Joins combine the days of the intersection of the windows; every change takes a new revision
+TEST_CASE(calendarJoinsAndRevisions) {
+    const Calendar lhs = calendar2024();
+    Calendar rhs("2024-03-01"_date, "2025-06-30"_date, { std::chrono::Friday, std::chrono::Saturday });
+    rhs.addHoliday("2024-05-01"_date);
+
+    const Calendar holidays = joinHolidays(lhs, rhs);
+    const Calendar business_days = joinBusinessDays(lhs, rhs);
+    CHECK(holidays.first() == "2024-03-01"_date && holidays.last() == "2025-01-10"_date);
+    bool matches = true;
+    for (Date date = holidays.first(); date <= holidays.last(); date += Days(1)) {
+        matches = matches && holidays.isBusinessDay(date) == (lhs.isBusinessDay(date) && rhs.isBusinessDay(date))
+            && business_days.isBusinessDay(date) == (lhs.isBusinessDay(date) || rhs.isBusinessDay(date));
+    }
+    CHECK(matches);
+    CHECK_THROWS(joinHolidays(lhs, Calendar("2025-02-01"_date, "2025-03-01"_date)), std::invalid_argument);
+
+    Calendar copy = lhs;
+    CHECK(copy.revision() == lhs.revision());
+    copy.addHoliday("2024-07-04"_date);
+    CHECK(copy.revision() != lhs.revision() && copy.revision() != rhs.revision());
+}
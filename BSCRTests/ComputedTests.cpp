@@ -0,0 +1,92 @@
+#include <functional>
+#include <string>
+#include <vector>
+#include "Computed.h"
+#include "ObservableValue.h"
+#include "Test.h"
+#include "Transaction.h"
+
+using namespace HKUltra;
+
+namespace {
+
+    // Observer recording the values it is notified with
+    struct RecordingObserver : Observer<int, ValueVersion> {
+        std::vector<int> values;
+
+        void onNotify(const int& value, const ValueVersion&) override {
+            values.push_back(value);
+        }
+    };
+
+    // Value running a hook when compared, so user code runs while it is being stored
+    struct Probe {
+        std::string text;
+        std::function<void()> hook;
+
+        bool operator!=(const Probe& rhs) const {
+            if (hook) {
+                hook();
+            }
+            return text != rhs.text;
+        }
+    };
+
+} // namespace
+
+// Without observers, a value is only computed when read, once for any number of changes
+TEST_CASE(computedIsLazy) {
+    ObservableValue<int> source(1);
+    int computations = 0;
+    Computed<int> twice([&computations](int value) { ++computations; return 2 * value; }, source);
+    CHECK(computations == 1 && twice.get() == 2 && computations == 1);
+    source.set(2);
+    source.set(3);
+    CHECK(computations == 1);
+    CHECK(twice.get() == 6 && twice.get() == 6 && computations == 2);
+    CHECK(twice.version() == 2);
+}
+
+// A diamond is refreshed once per change, after both of its paths, and never notifies a mixed state
+TEST_CASE(computedDiamondIsGlitchFree) {
+    ObservableValue<int> source(1);
+    Computed<int> twice([](int value) { return 2 * value; }, source);
+    Computed<int> next([](int value) { return value + 1; }, source);
+    int computations = 0;
+    Computed<int> sum([&computations](int lhs, int rhs) { ++computations; return lhs + rhs; }, twice, next);
+    Computed<int> parity([](int value) { return value % 2; }, sum);
+    CHECK(sum.rank() == 2 && parity.rank() == 3);
+    RecordingObserver sum_observer;
+    RecordingObserver parity_observer;
+    sum_observer.registerWith(sum);
+    parity_observer.registerWith(parity);
+
+    computations = 0;
+    source.set(5);  // 10 + 6: never 2 + 6 nor 10 + 2
+    source.set(6);  // 12 + 7
+    CHECK(sum_observer.values == std::vector<int>({ 16, 19 }));
+    CHECK(computations == 2);
+    CHECK(parity_observer.values == std::vector<int>({ 1 }));  // 16 has the parity of 4: only 19 changed it
+
+    source.set(6);  // Unchanged: no wave
+    CHECK(sum.get() == 19);
+    CHECK(sum_observer.values.size() == 2 && computations == 2);  // Still clean: not recomputed
+}
+
+// Code running while a commit stores its values never reads a Computed value older than the values already stored
+TEST_CASE(computedIsNeverStaleDuringStores) {
+    ObservableValue<long> source(0);
+    Computed<long> next([](long value) { return value + 1; }, source);
+    CHECK(next.get() == 1);
+    ObservableValue<Probe> probe(Probe{ "a", nullptr });
+    long seen_source = -1;
+    long seen_next = -1;
+    {
+        Transaction transaction;
+        source.set(10);
+        probe.set(Probe{ "b", [&] { seen_source = source.get(); seen_next = next.get(); } });
+        transaction.commit();  // Stores source, then compares the probes
+    }
+    CHECK(seen_source == 10 && seen_next == 11);
+    CHECK(next.get() == 11);
+}
@@ -0,0 +1,50 @@
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "DateConversion.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+// The scalar kernels agree with std::chrono over the whole supported range
+TEST_CASE(scalarConversionMatchesChrono) {
+    const std::int32_t first = std::chrono::sys_days(std::chrono::year(-32767) / 1 / 1).time_since_epoch().count();
+    const std::int32_t last = std::chrono::sys_days(std::chrono::year(32767) / 12 / 31).time_since_epoch().count();
+    bool matches = true;
+    for (std::int32_t serial_number = first; serial_number <= last; serial_number += 97) {  // Every weekday and month position
+        const std::chrono::year_month_day expected{ std::chrono::sys_days(std::chrono::days(serial_number)) };
+        const CivilDate date = civilFromSerial(serial_number);
+        matches = matches && date.year == int(expected.year()) && date.month == unsigned(expected.month())
+            && date.day == unsigned(expected.day()) && serialFromCivil(date) == serial_number;
+    }
+    CHECK(matches);
+    CHECK(civilFromSerial(last).year == 32767);
+    CHECK(serialFromCivil(1970, 1, 1) == 0);
+    CHECK(serialFromCivil(2000, 2, 29) == 11016);
+}
+
+// The batch conversions, vectorized when the target allows it, agree with the scalar kernels
+TEST_CASE(batchConversionMatchesScalar) {
+    std::vector<std::int32_t> serial_numbers;
+    for (std::int32_t serial_number = -800000; serial_number < 800000; serial_number += 1237) {
+        serial_numbers.push_back(serial_number);
+    }
+    serial_numbers.push_back(0);  // Odd size, so the scalar tail runs as well
+    const std::size_t size = serial_numbers.size();
+    std::vector<std::int32_t> years(size);
+    std::vector<std::uint32_t> months(size);
+    std::vector<std::uint32_t> days(size);
+    civilFromSerials(serial_numbers, years, months, days);
+    std::vector<std::int32_t> round_trip(size);
+    serialsFromCivil(years, months, days, round_trip);
+
+    bool matches = true;
+    for (std::size_t i = 0; i < size; ++i) {
+        const CivilDate date = civilFromSerial(serial_numbers[i]);
+        matches = matches && years[i] == date.year && months[i] == date.month && days[i] == date.day;
+    }
+    CHECK(matches);
+    CHECK(round_trip == serial_numbers);
+    CHECK_THROWS(civilFromSerials(serial_numbers, std::span(years).first(1), months, days), std::invalid_argument);
+}
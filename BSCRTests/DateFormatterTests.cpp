@@ -0,0 +1,49 @@
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Date.h"
+#include "DateFormatter.h"
+#include "DateParser.h"
+#include "DateVector.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+// Dates format in both formats, and years the formats cannot hold are rejected
+TEST_CASE(formatSingleDates) {
+    CHECK(toString("2024-02-29"_date) == "2024-02-29");
+    CHECK(toString("0001-01-09"_date, DateFormat::Compact) == "00010109");
+    static_assert([] {
+        char buffer[10];
+        return formatDate("1999-12-31"_date, buffer) == buffer + 10 && buffer[4] == '-' && buffer[9] == '1';
+        }());
+    CHECK_THROWS(toString(Date(Year(10000), Month(1), Day(1))), std::out_of_range);
+    CHECK_THROWS(toString(Date(Year(-1), Month(12), Day(31))), std::out_of_range);
+}
+
+// Batch formatting writes what parseDates reads
+TEST_CASE(formatDatesRoundTrip) {
+    DateVector dates;
+    for (Date date = "1899-12-30"_date; date < "2101-01-01"_date; date += Days(73)) {
+        dates.pushBack(date);
+    }
+    std::vector<char> buffer(dates.size() * 9);
+    const std::size_t size = formatDates(dates, buffer, DateFormat::Compact, ',');
+    CHECK(size == buffer.size());
+    DateVector parsed;
+    parseDates(std::string_view(buffer.data(), size), parsed, DateFormat::Compact, ',');
+    CHECK(parsed.size() == dates.size());
+    CHECK(toString(parsed[0]) == "1899-12-30" && parsed[parsed.size() - 1] == dates[dates.size() - 1]);
+
+    std::vector<char> small(dates.size() * 11 - 1);
+    CHECK_THROWS(formatDates(dates, small), std::length_error);
+}
+
+#if defined(__cpp_lib_format)
+// std::format writes the ISO format by default, and the compact one with "c"
+TEST_CASE(formatWithStdFormat) {
+    CHECK(std::format("{}", "2024-03-01"_date) == "2024-03-01");
+    CHECK(std::format("{:c}|{}", "2024-03-01"_date, "1970-01-01"_date) == "20240301|1970-01-01");
+}
+#endif
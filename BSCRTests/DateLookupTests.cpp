@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include "DateConversion.h"
+#include "DateLookup.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+static_assert(DateLookup::yearStart(1970) == 0 && DateLookup::daysInMonth(2100, 2) == 28 && DateLookup::daysInMonth(2000, 2) == 29);
+
+namespace {
+
+    // Serial number of a civil date, from std::chrono
+    std::int32_t serialOf(const std::chrono::year_month_day& date) {
+        return std::chrono::sys_days(date).time_since_epoch().count();
+    }
+
+} // namespace
+
+// Table lookups agree with std::chrono inside the window of the tables, across its bounds and outside it
+TEST_CASE(lookupsMatchChrono) {
+    using namespace std::chrono;
+    const std::int32_t first = serialOf(year(HKULTRA_DATE_LOOKUP_FIRST_YEAR - 50) / 1 / 1);
+    const std::int32_t end = serialOf(year(HKULTRA_DATE_LOOKUP_LAST_YEAR + 50) / 12 / 31);
+    bool matches = true;
+    for (std::int32_t serial_number = first; serial_number <= end; ++serial_number) {
+        const year_month_day expected{ sys_days(days(serial_number)) };
+        const CivilDate date = DateLookup::civil(serial_number);
+        const std::int32_t month_end = serialOf(expected.year() / expected.month() / std::chrono::last);
+        matches = matches && date.year == int(expected.year()) && date.month == unsigned(expected.month()) && date.day == unsigned(expected.day())
+            && DateLookup::dayOfYear(serial_number) == std::uint32_t(serial_number - serialOf(expected.year() / 1 / 1) + 1)
+            && DateLookup::weekday(serial_number) == weekday(sys_days(days(serial_number))).c_encoding()
+            && DateLookup::monthEnd(serial_number) == month_end
+            && DateLookup::daysInMonth(date.year, date.month) == std::uint32_t(month_end - serialOf(expected.year() / expected.month() / 1) + 1);
+    }
+    CHECK(matches);
+}
+
+// Adding months clamps to the end of the month, whether the months are in the window or not
+TEST_CASE(lookupAddMonths) {
+    using namespace std::chrono;
+    bool matches = true;
+    for (std::int32_t year_number : { HKULTRA_DATE_LOOKUP_FIRST_YEAR - 1, 1999, 2024, HKULTRA_DATE_LOOKUP_LAST_YEAR }) {
+        for (unsigned day_number : { 1u, 28u, 29u, 30u, 31u }) {
+            const year_month_day start = year(year_number) / 1 / std::min(day_number, 31u);
+            for (std::int32_t offset : { -25, -13, -1, 1, 2, 11, 14, 26 }) {
+                const year_month shifted = start.year() / start.month() + months(offset);
+                const year_month_day end_of_month = shifted / std::chrono::last;
+                const year_month_day expected = shifted / std::min(start.day(), end_of_month.day());
+                matches = matches && DateLookup::addMonths(serialOf(start), offset) == serialOf(expected);
+            }
+        }
+    }
+    CHECK(matches);
+    static_assert(DateLookup::addMonths(serialFromCivil(2024, 1, 31), 1) == serialFromCivil(2024, 2, 29));
+}
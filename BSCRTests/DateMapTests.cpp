@@ -0,0 +1,50 @@
+#include <functional>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+#include "Date.h"
+#include "DateMap.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+// Dates key unordered containers, consecutive dates having distinct hashes
+TEST_CASE(dateHash) {
+    std::unordered_set<Date> dates;
+    std::unordered_set<std::size_t> hashes;
+    for (Date date = "2024-01-01"_date; date < "2025-01-01"_date; date += Days(1)) {
+        dates.insert(date);
+        hashes.insert(std::hash<Date>()(date));
+    }
+    CHECK(dates.size() == 366 && hashes.size() == 366);
+    CHECK(dates.count("2024-02-29"_date) == 1 && dates.count("2025-01-01"_date) == 0);
+}
+
+// Dates of the window are stored densely; other dates go to the hash map, or are rejected without it
+TEST_CASE(dateMapWindowAndSparseDates) {
+    DateMap<int> map("2024-01-01"_date, "2024-12-31"_date);
+    map.set("2024-03-01"_date, 1);
+    map["2024-12-31"_date] += 2;
+    map["2023-12-31"_date] = 3;  // Outside the window
+    map.set("2030-06-15"_date, 4);
+    CHECK(map.size() == 4);
+    CHECK(*map.find("2024-03-01"_date) == 1 && *map.find("2024-12-31"_date) == 2);
+    CHECK(*map.find("2023-12-31"_date) == 3 && map.contains("2030-06-15"_date));
+    CHECK(!map.find("2024-03-02"_date) && !map.find("2025-01-01"_date));
+
+    std::vector<Date> visited;
+    map.forEach([&visited](const Date& date, int) { visited.push_back(date); });
+    CHECK(visited.size() == 4 && visited[0] == "2024-03-01"_date && visited[1] == "2024-12-31"_date);
+
+    CHECK(map.erase("2024-03-01"_date) && !map.erase("2024-03-01"_date) && map.erase("2030-06-15"_date));
+    CHECK(map.size() == 2);
+    map.clear();
+    CHECK(map.empty() && map.first() == "2024-01-01"_date && map.last() == "2024-12-31"_date);
+
+    DateMap<int, false> dense("2024-01-01"_date, "2024-01-31"_date);
+    dense.set("2024-01-31"_date, 5);
+    CHECK(*dense.find("2024-01-31"_date) == 5 && !dense.find("2024-01-30"_date));
+    CHECK_THROWS(dense.find("2024-02-01"_date), std::out_of_range);
+    CHECK_THROWS(dense.set("2024-02-01"_date, 6), std::out_of_range);
+    CHECK_THROWS((DateMap<int>("2024-01-02"_date, "2024-01-01"_date)), std::invalid_argument);
+}
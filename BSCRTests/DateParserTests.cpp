@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "Date.h"
+#include "DateParser.h"
+#include "DateVector.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+namespace {
+
+    // Text of `count` consecutive dates from 2023-12-25 in a format, each followed by the delimiter
+    std::string datesText(std::size_t count, DateFormat format, char delimiter) {
+        std::string text;
+        for (std::size_t i = 0; i < count; ++i) {
+            const CivilDate date = civilFromSerial(("2023-12-25"_date + Days(i)).serialNumber());
+            const std::string month = (date.month < 10 ? "0" : "") + std::to_string(date.month);
+            const std::string day = (date.day < 10 ? "0" : "") + std::to_string(date.day);
+            text += std::to_string(date.year) + (format == DateFormat::Iso ? "-" + month + "-" : month) + day + delimiter;
+        }
+        return text;
+    }
+
+    // Returns the message of the exception thrown by parseDates, or an empty string
+    std::string parseError(std::string_view text, DateVector& dates) {
+        try {
+            parseDates(text, dates);
+        }
+        catch (const std::invalid_argument& error) {
+            return error.what();
+        }
+        return std::string();
+    }
+
+} // namespace
+
+// Single dates parse in both formats, and malformed or nonexistent dates are rejected
+TEST_CASE(parseSingleDates) {
+    CHECK(parseDate("2024-02-29") == "2024-02-29"_date);
+    CHECK(parseDate("20240229") == "2024-02-29"_date);
+    Date date = "2000-01-01"_date;
+    CHECK(!tryParseDate("2023-02-29", date));
+    CHECK(!tryParseDate("1900-02-29", date));
+    CHECK(parseDate("2400-02-29") == "2400-02-29"_date);  // Outside the lookup window
+    CHECK(!tryParseDate("2300-02-29", date));
+    CHECK(!tryParseDate("2023-1-01", date));
+    CHECK(!tryParseDate("2023/01/01", date));
+    CHECK(date == "2000-01-01"_date);  // Unchanged on failure
+    CHECK_THROWS(parseDate("2023-13-01"), std::invalid_argument);
+}
+
+// Buffers of many dates, checked in vector blocks with a scalar tail, give the dates in order
+TEST_CASE(parseDateBuffers) {
+    for (DateFormat format : { DateFormat::Iso, DateFormat::Compact }) {
+        for (char delimiter : { '\n', ',' }) {
+            std::string text = datesText(101, format, delimiter);
+            text.pop_back();  // The last delimiter may be omitted
+            DateVector dates;
+            parseDates(text, dates, format, delimiter);
+            bool matches = dates.size() == 101;
+            for (std::size_t i = 0; matches && i < dates.size(); ++i) {
+                matches = dates[i] == "2023-12-25"_date + Days(i);
+            }
+            CHECK(matches);
+        }
+    }
+}
+
+// A malformed or nonexistent date is reported with its offset, and no date is appended
+TEST_CASE(parseDatesReportsOffsets) {
+    DateVector dates(1, "2000-01-01"_date);
+    std::string text = datesText(70, DateFormat::Iso, '\n');
+    text.replace(55 * 11, 10, "2023-02-29");
+    CHECK(parseError(text, dates) == "Invalid date at offset 605.");
+    text = datesText(70, DateFormat::Iso, '\n');
+    text[3 * 11 + 4] = '/';
+    CHECK(parseError(text, dates) == "Invalid date at offset 33.");
+    CHECK(parseError("2023-01-01\n2023-01", dates) == "Invalid date at offset 11.");
+    CHECK(dates.size() == 1);
+}
+
+// Chunked parsing carries split dates over, and rejects a chunk without consuming any of it
+TEST_CASE(streamParserCarriesSplitDates) {
+    const std::string text = datesText(90, DateFormat::Iso, '\n');
+    DateVector dates;
+    DateStreamParser parser(dates);
+    for (std::size_t begin = 0; begin < text.size(); begin += 7) {
+        parser.parse(std::string_view(text).substr(begin, 7));
+    }
+    parser.finish();
+    DateVector expected;
+    parseDates(text, expected);
+    CHECK(dates.serialNumbers().size() == 90);
+    CHECK(std::equal(dates.serialNumbers().begin(), dates.serialNumbers().end(), expected.serialNumbers().begin()));
+
+    DateVector streamed;
+    DateStreamParser failing(streamed);
+    failing.parse("2024-01-01\n2024-");
+    bool reported = false;
+    try {
+        failing.parse("01-02\n2024-02-30\n");
+    }
+    catch (const std::invalid_argument& error) {
+        reported = std::string(error.what()) == "Invalid date at offset 22.";
+    }
+    CHECK(reported);
+    CHECK(streamed.size() == 1);
+    failing.parse("01-02\n2024-02-29");  // The carried date is still pending
+    failing.finish();
+    CHECK(streamed.size() == 3);
+    CHECK(streamed[2] == "2024-02-29"_date);
+}
@@ -0,0 +1,61 @@
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+#include "Calendar.h"
+#include "Date.h"
+#include "DateRange.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+static_assert(std::ranges::forward_range<DayRange> && std::ranges::view<DayRange> && std::ranges::borrowed_range<DayRange>);
+static_assert(std::ranges::forward_range<MonthRange> && std::ranges::view<MonthRange>);
+
+namespace {
+
+    // Collects the dates of a range
+    template <typename _range>
+    std::vector<Date> datesOf(_range&& range) {
+        std::vector<Date> dates;
+        for (const Date& date : range) {
+            dates.push_back(date);
+        }
+        return dates;
+    }
+
+} // namespace
+
+// Day ranges exclude the end date and stop at the first step past it
+TEST_CASE(dayRanges) {
+    CHECK(datesOf(dateRange("2024-02-27"_date, "2024-03-02"_date, Days(1)))
+        == std::vector<Date>({ "2024-02-27"_date, "2024-02-28"_date, "2024-02-29"_date, "2024-03-01"_date }));
+    CHECK(datesOf(dateRange("2024-01-01"_date, "2024-01-15"_date, Days(7)))
+        == std::vector<Date>({ "2024-01-01"_date, "2024-01-08"_date }));
+    CHECK(dateRange("2024-01-01"_date, "2024-01-01"_date, Days(1)).empty());
+    CHECK(std::ranges::distance(dateRange("2024-01-01"_date, "2025-01-01"_date, Days(1))) == 366);
+    CHECK_THROWS(dateRange("2024-01-01"_date, "2024-02-01"_date, Days(0)), std::invalid_argument);
+}
+
+// Month and year ranges keep the day of the start date, clamped to shorter months
+TEST_CASE(monthRanges) {
+    CHECK(datesOf(dateRange("2024-01-31"_date, "2024-06-01"_date, Months(1))) == std::vector<Date>({ "2024-01-31"_date,
+        "2024-02-29"_date, "2024-03-31"_date, "2024-04-30"_date, "2024-05-31"_date }));
+    CHECK(datesOf(dateRange("2024-02-29"_date, "2029-01-01"_date, Years(2)))
+        == std::vector<Date>({ "2024-02-29"_date, "2026-02-28"_date, "2028-02-29"_date }));
+    CHECK(datesOf(dateRange(Date(Year(-1), Month(11), Day(30)), Date(Year(0), Month(3), Day(1)), Months(1)))
+        == std::vector<Date>({ Date(Year(-1), Month(11), Day(30)), Date(Year(-1), Month(12), Day(30)),
+            Date(Year(0), Month(1), Day(30)), Date(Year(0), Month(2), Day(29)) }));
+    CHECK_THROWS(dateRange("2024-01-01"_date, "2024-02-01"_date, Months(-1)), std::invalid_argument);
+}
+
+// Ranges compose with the standard adaptors and the business day filter
+TEST_CASE(dateRangesCompose) {
+    const Calendar calendar("2024-01-01"_date, "2024-12-31"_date);
+    auto business_days = dateRange("2024-03-28"_date, "2024-04-04"_date, Days(1)) | businessDays(calendar);
+    CHECK(datesOf(business_days) == std::vector<Date>({ "2024-03-28"_date, "2024-03-29"_date, "2024-04-01"_date,
+        "2024-04-02"_date, "2024-04-03"_date }));
+    auto month_ends = dateRange("2024-01-31"_date, "2025-01-01"_date, Months(1))
+        | std::views::filter([&calendar](const Date& date) { return calendar.isHoliday(date); }) | std::views::take(2);
+    CHECK(datesOf(month_ends) == std::vector<Date>({ "2024-03-31"_date, "2024-06-30"_date }));
+}
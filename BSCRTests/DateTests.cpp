@@ -0,0 +1,56 @@
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include "Date.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+// A Date is its serial number: copied, compared and published atomically without a lock
+TEST_CASE(dateIsLockFreeValue) {
+    CHECK(sizeof(Date) == 4);
+    CHECK(std::atomic<Date>::is_always_lock_free);
+
+    const Date date(Year(2024), Month(2), Day(29));
+    CHECK(date.serialNumber() == 19782);  // Days since 1970-01-01
+    CHECK(Date(date.serialNumber()) == date);
+    CHECK(Date() == Date(Year(1900), Month(1), Day(1)));
+    CHECK_THROWS(Date(Year(2023), Month(2), Day(29)), std::invalid_argument);
+
+    std::atomic<Date> shared(date);
+    std::thread writer([&] {
+        for (int i = 1; i <= 1000; ++i) {
+            shared.store(date + Days(i));
+        }
+        });
+    bool in_range = true;
+    for (int i = 0; i < 1000; ++i) {
+        const Date read = shared.load();
+        in_range = in_range && date <= read && read <= date + Days(1000);  // Never torn
+    }
+    writer.join();
+    CHECK(in_range);
+    CHECK(shared.load() == date + Days(1000));
+}
+
+// Construction, arithmetic and literals are evaluated at compile time
+TEST_CASE(dateIsConstexpr) {
+    constexpr Date date = "2024-01-31"_date;
+    static_assert(date == Date(Year(2024), Month(1), Day(31)));
+    static_assert(date + Months(1) == "2024-02-29"_date, "Month arithmetic clamps to the end of the month");
+    static_assert(date + Years(1) == "2025-01-31"_date);
+    static_assert(date - Days(31) == "2023-12-31"_date);
+    static_assert(("2023-03-31"_date - Months(1)).day() == Day(28));
+    static_assert(date.year() == Year(2024) && date.month() == Month(1));
+
+    // The same operations at run time give the same dates
+    Date shifted = date;
+    shifted += Months(13);
+    CHECK(shifted == "2025-02-28"_date);
+    shifted -= Years(1);
+    CHECK(shifted == "2024-02-28"_date);
+    shifted += Days(2);
+    CHECK(shifted == "2024-03-01"_date);
+    CHECK(shifted > date);
+    CHECK(date <= shifted);
+}
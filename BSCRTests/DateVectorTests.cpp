@@ -0,0 +1,40 @@
+#include <cstddef>
+#include "Date.h"
+#include "DateVector.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+// Bulk shifts give the same dates as shifting each Date, including the end of month clamping
+TEST_CASE(bulkShiftsMatchDateArithmetic) {
+    DateVector dates;
+    for (Date date = "1999-12-01"_date; date <= "2004-03-31"_date; date += Days(3)) {
+        dates.pushBack(date);
+    }
+    dates.pushBack("2024-01-31"_date);  // Odd size, so the scalar tail runs as well
+    const DateVector original = dates;
+
+    dates.addMonths(Months(13));
+    bool matches = true;
+    for (std::size_t i = 0; i < dates.size(); ++i) {
+        matches = matches && dates[i] == original[i] + Months(13);
+    }
+    CHECK(matches);
+    CHECK(dates[dates.size() - 1] == "2025-02-28"_date);
+
+    dates = original;
+    dates.addMonths(Months(-25));
+    matches = true;
+    for (std::size_t i = 0; i < dates.size(); ++i) {
+        matches = matches && dates[i] == original[i] - Months(25);
+    }
+    CHECK(matches);
+
+    dates = original;
+    dates.addYears(Years(1)).addDays(Days(-1));
+    matches = true;
+    for (std::size_t i = 0; i < dates.size(); ++i) {
+        matches = matches && dates[i] == original[i] + Years(1) - Days(1);
+    }
+    CHECK(matches);
+}
@@ -0,0 +1,66 @@
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "Date.h"
+#include "DateVector.h"
+#include "DayCount.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+namespace {
+
+    constexpr DayCountConvention conventions[] = { DayCountConvention::Actual360, DayCountConvention::Actual365Fixed,
+        DayCountConvention::Thirty360US, DayCountConvention::Thirty360BondBasis, DayCountConvention::Thirty360European,
+        DayCountConvention::ActualActualISDA };
+
+    bool near(double lhs, double rhs) {
+        return std::abs(lhs - rhs) < 1e-12;
+    }
+
+} // namespace
+
+// The 30/360 conventions differ on the 31st and at the end of February
+TEST_CASE(thirty360DayCounts) {
+    static_assert(dayCount(DayCountConvention::Thirty360US, "2024-02-29"_date, "2024-03-31"_date) == 30);
+    CHECK(dayCount(DayCountConvention::Thirty360BondBasis, "2024-02-29"_date, "2024-03-31"_date) == 32);
+    CHECK(dayCount(DayCountConvention::Thirty360European, "2024-02-29"_date, "2024-03-31"_date) == 31);
+    CHECK(dayCount(DayCountConvention::Thirty360US, "2024-01-15"_date, "2024-03-31"_date) == 76);
+    CHECK(dayCount(DayCountConvention::Thirty360BondBasis, "2024-01-31"_date, "2024-03-31"_date) == 60);
+    CHECK(dayCount(DayCountConvention::Thirty360European, "2024-01-15"_date, "2024-03-31"_date) == 75);
+    CHECK(dayCount(DayCountConvention::Actual365Fixed, "2024-01-15"_date, "2024-03-31"_date) == 76);
+    CHECK(dayCount(DayCountConvention::Thirty360US, "2400-02-29"_date, "2400-03-31"_date) == 30);  // Outside the lookup window
+    CHECK(dayCount(DayCountConvention::Thirty360US, "2300-02-28"_date, "2300-03-31"_date) == 30);
+}
+
+// Year fractions, ACT/ACT ISDA splitting the days by calendar year, inside and outside its year table
+TEST_CASE(yearFractionsByConvention) {
+    CHECK(near(yearFraction(DayCountConvention::Actual360, "2024-01-01"_date, "2024-07-01"_date), 182.0 / 360));
+    CHECK(near(yearFraction(DayCountConvention::Actual365Fixed, "2024-07-01"_date, "2024-01-01"_date), -182.0 / 365));
+    CHECK(near(yearFraction(DayCountConvention::ActualActualISDA, "2024-01-01"_date, "2024-07-01"_date), 182.0 / 366));
+    CHECK(near(yearFraction(DayCountConvention::ActualActualISDA, "2023-07-01"_date, "2024-07-01"_date), 184.0 / 365 + 182.0 / 366));
+    CHECK(near(yearFraction(DayCountConvention::ActualActualISDA, "2500-01-01"_date, "2502-01-01"_date), 2.0));
+    CHECK(near(yearFraction(DayCountConvention::Thirty360European, "2024-01-31"_date, "2025-01-31"_date), 1.0));
+}
+
+// Batch year fractions match the scalar ones for every convention
+TEST_CASE(batchYearFractionsMatchScalar) {
+    DateVector starts;
+    DateVector ends;
+    for (Date date = "2019-01-31"_date; date < "2031-01-01"_date; date += Days(29)) {
+        starts.pushBack(date);
+        ends.pushBack(date + Months(7) + Days(date.serialNumber() % 5));
+    }
+    std::vector<double> fractions(starts.size());
+    for (DayCountConvention convention : conventions) {
+        yearFractions(convention, starts, ends, fractions);
+        bool matches = true;
+        for (std::size_t i = 0; i < fractions.size(); ++i) {
+            matches = matches && near(fractions[i], yearFraction(convention, starts[i], ends[i]));
+        }
+        CHECK(matches);
+    }
+    fractions.pop_back();
+    CHECK_THROWS(yearFractions(DayCountConvention::Actual360, starts, ends, fractions), std::invalid_argument);
+}
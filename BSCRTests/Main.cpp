@@ -0,0 +1,6 @@
+#include "Test.h"
+
+// Runs the tests of all the translation units of the project, failing if any check failed
+int main() {
+    return HKUltra::Testing::runTests() == 0 ? 0 : 1;
+}
@@ -0,0 +1,277 @@
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "LockPolicy.h"
+#include "Observable.h"
+#include "ObservableValue.h"
+#include "Signal.h"
+#include "StaticObservable.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+namespace {
+
+    // Argument counting its copies
+    struct CopyCounter {
+        static inline int copies = 0;
+
+        CopyCounter() = default;
+
+        CopyCounter(const CopyCounter&) {
+            ++copies;
+        }
+    };
+
+    struct ReferenceObserver : Observer<CopyCounter> {
+        int calls = 0;
+
+        void onNotify(const CopyCounter&) override {
+            ++calls;
+        }
+    };
+
+    struct OwnedObserver : OwningObserver<CopyCounter> {
+        int calls = 0;
+
+        void onNotifyOwned(CopyCounter) override {
+            ++calls;
+        }
+    };
+
+    struct CallbackObserver : Observer<int> {
+        int calls = 0;
+        std::function<void()> callback;  // Called on each notification, if set
+
+        void onNotify(const int&) override {
+            ++calls;
+            if (callback) {
+                callback();
+            }
+        }
+    };
+
+    struct SumObserver : StaticObserver<SumObserver, int> {
+        int total = 0;
+
+        void onNotify(const int& value) {
+            total += value;
+        }
+    };
+
+} // namespace
+
+// Observers receive the arguments by reference; only owning observers pay for a copy
+TEST_CASE(notifyCopiesOnlyForOwningObservers) {
+    Observable<CopyCounter> observable;
+    std::vector<ReferenceObserver> observers(3);
+    for (ReferenceObserver& observer : observers) {
+        observer.registerWith(observable);
+    }
+    OwnedObserver owned;
+    owned.registerWith(observable);
+
+    const CopyCounter argument;
+    CopyCounter::copies = 0;
+    observable.notifyObservers(argument);
+    for (const ReferenceObserver& observer : observers) {
+        CHECK(observer.calls == 1);
+    }
+    CHECK(owned.calls == 1);
+    CHECK(CopyCounter::copies == 1);
+}
+
+// Statically dispatched observers are notified, unregistered, and unsubscribed on destruction
+TEST_CASE(staticObserverNotified) {
+    StaticObservable<SumObserver, int> first;
+    StaticObservable<SumObserver, int> second;
+    SumObserver observer;
+    observer.registerWith(first);
+    observer.registerWith(second);
+    first.notifyObservers(1);
+    second.notifyObservers(10);
+    CHECK(observer.total == 11);
+
+    observer.unregisterWith(first);
+    first.notifyObservers(100);
+    CHECK(observer.total == 11);
+    {
+        SumObserver temporary;
+        temporary.registerWith(second);
+        CHECK(second.hasObservers());
+    }
+    second.notifyObservers(1000);  // The destroyed observer is no longer registered
+    CHECK(observer.total == 1011);
+}
+
+// Registration is idempotent, and unregistering from many observers keeps the others
+TEST_CASE(subscriptionBookkeeping) {
+    Observable<int> observable;
+    {
+        CallbackObserver observer;
+        observer.registerWith(observable);
+        observer.registerWith(observable);
+        observable.notifyObservers(1);
+        CHECK(observer.calls == 1);
+    }
+    CHECK(!observable.hasObservers());
+
+    std::vector<std::unique_ptr<CallbackObserver>> observers;
+    for (int i = 0; i < 1000; ++i) {  // Grows the subscription index several times
+        observers.push_back(std::make_unique<CallbackObserver>());
+        observers.back()->registerWith(observable);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        observers[i]->unregisterWith(observable);
+    }
+    observable.notifyObservers(1);
+    bool notified_once = true;
+    for (int i = 0; i < 1000; ++i) {
+        notified_once = notified_once && observers[i]->calls == i % 2;
+    }
+    CHECK(notified_once);
+    observers.clear();
+    CHECK(!observable.hasObservers());
+
+    // An observer outliving its observable is unsubscribed when the observable is destroyed
+    CallbackObserver survivor;
+    {
+        Observable<int> temporary;
+        survivor.registerWith(temporary);
+    }
+    survivor.unregisterWith(observable);  // Must not touch the destroyed observable
+    CHECK(survivor.calls == 0);
+}
+
+// Observers may unregister themselves or others, and notify other observables, from onNotify
+TEST_CASE(reentrantNotification) {
+    Observable<int> observable;
+    CallbackObserver first;
+    CallbackObserver second;
+    first.registerWith(observable);
+    second.registerWith(observable);
+    first.callback = [&] { second.unregisterWith(observable); };
+    second.callback = [&] { first.unregisterWith(observable); };
+    observable.notifyObservers(1);
+    CHECK(first.calls + second.calls == 1);  // Whichever runs first hides the other from the running notification
+
+    Observable<int> relay;
+    CallbackObserver target;
+    CallbackObserver relayer;
+    target.registerWith(relay);
+    relayer.registerWith(observable);
+    relayer.callback = [&] {
+        relay.notifyObservers(2);
+        relayer.unregisterWith(observable);
+    };
+    observable.notifyObservers(1);
+    observable.notifyObservers(1);
+    CHECK(relayer.calls == 1);
+    CHECK(target.calls == 1);
+}
+
+// Threads notifying two observables may each unregister from the other observable without deadlocking
+TEST_CASE(crossUnregisterFromNotifications) {
+    Observable<int> first;
+    Observable<int> second;
+    CallbackObserver first_relay;
+    CallbackObserver second_relay;
+    CallbackObserver first_target;
+    CallbackObserver second_target;
+    first_relay.registerWith(first);
+    second_relay.registerWith(second);
+    first_target.registerWith(first);
+    second_target.registerWith(second);
+
+    std::atomic<int> arrived{ 0 };
+    auto meet = [&] {  // Both threads are notifying when either unregisters
+        ++arrived;
+        while (arrived < 2) {
+            std::this_thread::yield();
+        }
+    };
+    first_relay.callback = [&] {
+        meet();
+        second_target.unregisterWith(second);
+    };
+    second_relay.callback = [&] {
+        meet();
+        first_target.unregisterWith(first);
+    };
+    std::thread thread([&] { second.notifyObservers(1); });
+    first.notifyObservers(1);
+    thread.join();  // Deadlocked when each thread waited for the other's notification to end
+
+    first.notifyObservers(2);
+    second.notifyObservers(2);
+    CHECK(first_relay.calls == 2 && second_relay.calls == 2);
+    CHECK(first_target.calls <= 1 && second_target.calls <= 1);  // Never notified once unregistered
+}
+
+// Lock policies: spin-locked signals and shared-locked values across threads
+TEST_CASE(lockPolicies) {
+    BasicSignal<std::function<void(const int&)>, SpinLock, int> signal;
+    std::atomic<int> total{ 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 250; ++i) {
+                const Connection connection = signal.connect([&](const int& value) { total += value; });
+                signal.emit(1);
+                signal.disconnect(connection);
+            }
+            });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    CHECK(total >= 1000);  // Each emission reaches at least the slot its thread connected
+
+    ObservableValue<int, SharedLock> value(0);
+    std::thread writer([&] {
+        for (int i = 1; i <= 1000; ++i) {
+            value.set(i);
+        }
+        });
+    int last = 0;
+    bool monotonic = true;
+    while (last < 1000) {
+        const int current = value.get();
+        monotonic = monotonic && current >= last;
+        last = current;
+    }
+    writer.join();
+    CHECK(monotonic);
+}
+
+// NullLock observables used on different threads share the subscription pool safely
+TEST_CASE(nullLockObservablesOnSeparateThreads) {
+    struct Counter : BasicObserver<NullLock, int> {
+        int calls = 0;
+
+        void onNotify(const int&) override {
+            ++calls;
+        }
+    };
+    auto run = [] {
+        int calls = 0;
+        for (int i = 0; i < 2000; ++i) {
+            BasicObservable<NullLock, int> observable;
+            Counter counter;
+            counter.registerWith(observable);  // Takes a node from the process-wide pool
+            observable.notifyObservers(i);
+            counter.unregisterWith(observable);  // Returns it
+            calls += counter.calls;
+        }
+        return calls;
+    };
+    int first = 0;
+    int second = 0;
+    std::thread thread([&] { first = run(); });
+    second = run();
+    thread.join();
+    CHECK(first == 2000);
+    CHECK(second == 2000);
+}
@@ -0,0 +1,102 @@
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LockPolicy.h"
+#include "ObservableValue.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+namespace {
+
+    // Observer counting its notifications and summing the values, from any thread
+    template <typename _lock>
+    struct SumObserver : BasicObserver<_lock, int, ValueVersion> {
+        std::atomic<int> calls = 0;
+        std::atomic<std::int64_t> total = 0;
+
+        void onNotify(const int& value, const ValueVersion&) override {
+            ++calls;
+            total += value;
+        }
+    };
+
+    // Observer counting its notifications and keeping the last value and version
+    template <typename _type>
+    struct LastObserver : Observer<_type, ValueVersion> {
+        int calls = 0;
+        _type value = _type();
+        ValueVersion version = 0;
+
+        void onNotify(const _type& notified_value, const ValueVersion& notified_version) override {
+            ++calls;
+            value = notified_value;
+            version = notified_version;
+        }
+    };
+
+} // namespace
+
+// Concurrent updates are never lost, and each one is notified once with its own result
+TEST_CASE(updateNeverLosesChanges) {
+    ObservableValue<int, SpinLock> value(0);
+    SumObserver<SpinLock> observer;
+    observer.registerWith(value);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&value] {
+            for (int i = 0; i < 2500; ++i) {
+                value.update([](int current) { return current + 1; });
+            }
+            });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    CHECK(value.get() == 10000);
+    CHECK(observer.calls == 10000);
+    CHECK(observer.total == std::int64_t(10000) * 10001 / 2);  // Every intermediate value exactly once
+
+    CHECK(value.update([](int current) { return current; }) == 10000);  // Unchanged: not notified
+    CHECK(observer.calls == 10000);
+}
+
+// compareAndSet replaces and notifies only if the expected value matches
+TEST_CASE(compareAndSetNotifiesOnSuccess) {
+    ObservableValue<std::string> value("a");
+    LastObserver<std::string> observer;
+    observer.registerWith(value);
+
+    CHECK(!value.compareAndSet("b", "c"));
+    CHECK(value.get() == "a" && observer.calls == 0);
+    CHECK(value.compareAndSet("a", "b"));
+    CHECK(value.get() == "b" && observer.calls == 1 && observer.value == "b" && observer.version == 2);
+    CHECK(value.compareAndSet("b", "b"));  // Matches, but nothing changes
+    CHECK(observer.calls == 1 && value.version() == 2);
+}
+
+// Only real changes are notified, each with the next version
+TEST_CASE(setNotifiesChangesWithVersions) {
+    ObservableValue<int> value(7);
+    LastObserver<int> observer;
+    observer.registerWith(value);
+    CHECK(value.version() == 1);
+    value.set(7);
+    CHECK(observer.calls == 0 && value.version() == 1);
+    value.set(8);
+    value.set(8);
+    value.set(9);
+    CHECK(observer.calls == 2 && observer.value == 9 && observer.version == 3);
+    const Versioned<int> read = value.getVersioned();
+    CHECK(read.value == 9 && read.version == 3);
+
+    ObservableValue<std::string> text("x");  // Locked storage
+    LastObserver<std::string> text_observer;
+    text_observer.registerWith(text);
+    text.set("x");
+    text.set("y");
+    text.set("y");
+    CHECK(text_observer.calls == 1 && text_observer.version == 2 && text.getVersioned().value == "y");
+}
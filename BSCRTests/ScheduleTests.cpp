@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <mutex>
+#include <stdexcept>
+#include "Calendar.h"
+#include "Date.h"
+#include "LockPolicy.h"
+#include "Schedule.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+namespace {
+
+    // Returns true if a schedule holds exactly the expected dates
+    bool hasDates(const DateVector& schedule, std::initializer_list<Date> expected) {
+        if (schedule.size() != expected.size()) {
+            return false;
+        }
+        std::size_t i = 0;
+        for (const Date& date : expected) {
+            if (schedule[i++] != date) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns true if two schedules hold the same dates
+    bool sameDates(const DateVector& lhs, const DateVector& rhs) {
+        return std::equal(lhs.serialNumbers().begin(), lhs.serialNumbers().end(), rhs.serialNumbers().begin(), rhs.serialNumbers().end());
+    }
+
+} // namespace
+
+// The generation rule places the stub, and the stub type decides whether it is merged
+TEST_CASE(scheduleStubs) {
+    ScheduleParameters parameters{ "2024-01-15"_date, "2025-04-15"_date, Months(6) };
+    parameters.rule = DateGenerationRule::Forward;
+    CHECK(hasDates(generateSchedule(parameters), { "2024-01-15"_date, "2024-07-15"_date, "2025-01-15"_date, "2025-04-15"_date }));
+    parameters.stub = StubType::Long;
+    CHECK(hasDates(generateSchedule(parameters), { "2024-01-15"_date, "2024-07-15"_date, "2025-04-15"_date }));
+    parameters.rule = DateGenerationRule::Backward;
+    CHECK(hasDates(generateSchedule(parameters), { "2024-01-15"_date, "2024-10-15"_date, "2025-04-15"_date }));
+    parameters.stub = StubType::Short;
+    CHECK(hasDates(generateSchedule(parameters), { "2024-01-15"_date, "2024-04-15"_date, "2024-10-15"_date, "2025-04-15"_date }));
+
+    parameters.tenor = Months(0);
+    CHECK_THROWS(generateSchedule(parameters), std::invalid_argument);
+    parameters = ScheduleParameters{ "2024-01-15"_date, "2025-01-15"_date };
+    parameters.convention = BusinessDayConvention::Following;
+    CHECK_THROWS(generateSchedule(parameters), std::invalid_argument);  // No calendar
+}
+
+// Month-end rolls, and adjustment with the business-day convention
+TEST_CASE(scheduleRollsAndAdjustments) {
+    ScheduleParameters parameters{ "2024-02-29"_date, "2024-08-31"_date, Months(2), DateGenerationRule::Forward };
+    parameters.end_of_month = true;
+    CHECK(hasDates(generateSchedule(parameters), { "2024-02-29"_date, "2024-04-30"_date, "2024-06-30"_date, "2024-08-31"_date }));
+
+    const Calendar calendar("2023-12-01"_date, "2024-12-31"_date);
+    parameters = ScheduleParameters{ "2024-01-31"_date, "2024-04-30"_date, Months(1), DateGenerationRule::Forward };
+    parameters.convention = BusinessDayConvention::ModifiedFollowing;
+    parameters.calendar = &calendar;
+    // March 31st is a Sunday: the following business day is in April, so the preceding one is taken
+    CHECK(hasDates(generateSchedule(parameters), { "2024-01-31"_date, "2024-02-29"_date, "2024-03-29"_date, "2024-04-30"_date }));
+
+    // A one-day short stub on a weekend: Saturday and Sunday both adjust to Monday, which is kept once
+    parameters = ScheduleParameters{ "2024-06-15"_date, "2024-12-16"_date, Months(6) };
+    parameters.convention = BusinessDayConvention::Following;
+    parameters.calendar = &calendar;
+    CHECK(hasDates(generateSchedule(parameters), { "2024-06-17"_date, "2024-12-16"_date }));
+    parameters.convention = BusinessDayConvention::Preceding;
+    CHECK(hasDates(generateSchedule(parameters), { "2024-06-14"_date, "2024-12-16"_date }));
+    parameters = ScheduleParameters{ "2024-06-15"_date, "2024-06-16"_date, Months(6) };
+    parameters.convention = BusinessDayConvention::Following;
+    parameters.calendar = &calendar;
+    CHECK_THROWS(generateSchedule(parameters), std::invalid_argument);  // Both dates adjust to the same Monday
+}
+
+// Schedules are shared until their calendar changes, and the cache keeps at most `capacity` of them
+TEST_CASE(scheduleCacheSharingAndEviction) {
+    Calendar calendar("2023-12-01"_date, "2026-12-31"_date);
+    ScheduleParameters parameters{ "2024-01-15"_date, "2026-01-15"_date, Months(3) };
+    parameters.convention = BusinessDayConvention::Following;
+    parameters.calendar = &calendar;
+
+    ScheduleCache<SharedLock> cache(2);
+    const ScheduleCache<SharedLock>::ScheduleType schedule = cache.get(parameters);
+    CHECK(cache.get(parameters) == schedule);
+    CHECK(cache.get(ScheduleParameters(parameters)) == schedule);
+
+    const Calendar copy = calendar;  // Same business days, same revision
+    parameters.calendar = &copy;
+    CHECK(cache.get(parameters) == schedule);
+
+    calendar.addHoliday("2024-04-15"_date);
+    parameters.calendar = &calendar;
+    const ScheduleCache<SharedLock>::ScheduleType adjusted = cache.get(parameters);
+    CHECK(adjusted != schedule);
+    CHECK((*adjusted)[1] == "2024-04-16"_date && (*schedule)[1] == "2024-04-15"_date);
+    CHECK(cache.size() == 2);
+
+    parameters.convention = BusinessDayConvention::Unadjusted;  // The calendar is not part of the key any more
+    const ScheduleCache<SharedLock>::ScheduleType unadjusted = cache.get(parameters);
+    parameters.calendar = nullptr;
+    CHECK(cache.get(parameters) == unadjusted);
+    CHECK(cache.size() == 2);  // The first schedule was evicted
+    parameters.calendar = &copy;
+    parameters.convention = BusinessDayConvention::Following;
+    CHECK(cache.get(parameters) != schedule && sameDates(*cache.get(parameters), *schedule));
+
+    cache.clear();
+    CHECK(cache.size() == 0 && adjusted->size() == 9);
+    CHECK_THROWS(ScheduleCache<std::mutex>(0), std::invalid_argument);
+}
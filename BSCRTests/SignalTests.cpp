@@ -0,0 +1,199 @@
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "InlineSlot.h"
+#include "Signal.h"
+#include "Test.h"
+
+using namespace HKUltra;
+
+// Slots run on the snapshot taken when the emission started
+TEST_CASE(emitRunsOnSnapshot) {
+    Signal<int> signal;
+    int total = 0;
+    signal.connect([&](const int& value) { total += value; });
+    signal.connect([&](const int& value) { total += 10 * value; });
+    signal.emit(2);
+    CHECK(total == 22);
+
+    // A slot connected during an emission is only called from the next one
+    Signal<> reentrant;
+    int calls = 0;
+    reentrant.connect([&] {
+        if (++calls == 1) {
+            reentrant.connect([&] { ++calls; });
+        }
+        });
+    reentrant.emit();
+    CHECK(calls == 1);
+    reentrant.emit();
+    CHECK(calls == 3);
+}
+
+// Slots may disconnect themselves while the signal is emitting, without deadlocking
+TEST_CASE(slotDisconnectsItself) {
+    Signal<> signal;
+    int calls = 0;
+    Connection connection;
+    connection = signal.connect([&] {
+        ++calls;
+        signal.disconnect(connection);
+        });
+    signal.emit();
+    signal.emit();
+    CHECK(calls == 1);
+    CHECK(!signal.connected(connection));
+}
+
+// Emissions on one thread run while another thread connects and disconnects
+TEST_CASE(emitWhileConnecting) {
+    Signal<int> signal;
+    std::atomic<long> total{ 0 };
+    signal.connect([&](const int& value) { total += value; });
+    std::atomic<bool> stop{ false };
+    std::thread emitter([&] {
+        while (!stop) {
+            signal.emit(1);
+        }
+        });
+    for (int i = 0; i < 1000; ++i) {
+        signal.disconnect(signal.connect([](const int&) {}));
+    }
+    stop = true;
+    emitter.join();
+    const long before = total;
+    signal.emit(1);
+    CHECK(total == before + 1);
+}
+
+// A disconnected handle stays stale even once its index is reused by another slot
+TEST_CASE(staleConnectionIgnored) {
+    Signal<int> signal;
+    int first = 0;
+    int second = 0;
+    const Connection stale = signal.connect([&](const int& value) { first += value; });
+    signal.disconnect(stale);
+    const Connection reused = signal.connect([&](const int& value) { second += value; });
+    CHECK(reused.index == stale.index);  // The freed index is reused with a new generation
+    CHECK(!signal.connected(stale));
+    CHECK(signal.connected(reused));
+
+    signal.disconnect(stale);  // Must not disconnect the slot now using the index
+    signal.emit(3);
+    CHECK(first == 0);
+    CHECK(second == 3);
+    signal.disconnect(Connection{});  // Never connected
+    CHECK(signal.connected(reused));
+}
+
+// Disconnecting from the middle keeps every other slot connected
+TEST_CASE(disconnectKeepsOtherSlots) {
+    Signal<> signal;
+    std::vector<int> calls(5, 0);
+    std::vector<Connection> connections;
+    for (int i = 0; i < 5; ++i) {
+        connections.push_back(signal.connect([&calls, i] { ++calls[i]; }));
+    }
+    signal.disconnect(connections[1]);
+    signal.emit();
+    CHECK((calls == std::vector<int>{ 1, 0, 1, 1, 1 }));
+    for (int i : { 0, 2, 3, 4 }) {
+        CHECK(signal.connected(connections[i]));
+    }
+}
+
+// Slots survive the rebuilds of the slot array, and those disconnected mid-emission are skipped
+TEST_CASE(slotArrayRebuilds) {
+    Signal<> signal;
+    std::vector<int> calls(1000, 0);
+    std::vector<Connection> connections;
+    for (int i = 0; i < 1000; ++i) {  // Grows the array several times
+        connections.push_back(signal.connect([&calls, i] { ++calls[i]; }));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 10 != 0) {  // Compacts the array several times
+            signal.disconnect(connections[i]);
+        }
+    }
+    signal.emit();
+    bool called_once = true;
+    for (int i = 0; i < 1000; ++i) {
+        called_once = called_once && calls[i] == (i % 10 == 0 ? 1 : 0);
+        called_once = called_once && signal.connected(connections[i]) == (i % 10 == 0);
+    }
+    CHECK(called_once);
+
+    Signal<> skipping;
+    int skipped_calls = 0;
+    Connection second;
+    skipping.connect([&] { skipping.disconnect(second); });
+    second = skipping.connect([&] { ++skipped_calls; });
+    skipping.emit();
+    CHECK(skipped_calls == 0);  // Disconnected before the emission reached it
+}
+
+// InlineSignal stores callables inline, copying and destroying non-trivial ones correctly
+TEST_CASE(inlineSlotStorage) {
+    struct Counter {
+        int total = 0;
+
+        void add(const int& value) {
+            total += value;
+        }
+    };
+    Counter counter;
+    auto shared = std::make_shared<int>(0);
+    {
+        InlineSignal<int> signal;
+        const Connection method = signal.connect(&counter, &Counter::add);
+        signal.connect([shared](const int& value) { *shared += value; });  // Not trivially copyable
+        signal.emit(4);
+        CHECK(counter.total == 4);
+        CHECK(*shared == 4);
+        signal.disconnect(method);
+        signal.emit(1);
+        CHECK(counter.total == 4);
+        CHECK(*shared == 5);
+    }
+    CHECK(shared.use_count() == 1);  // Every copy held by the slots and their snapshots was destroyed
+
+    InlineSlot<int> slot([&counter](const int& value) { counter.add(value); });
+    InlineSlot<int> moved(std::move(slot));
+    CHECK(!slot);
+    CHECK(static_cast<bool>(moved));
+    moved(2);
+    CHECK(counter.total == 6);
+}
+
+namespace {
+
+    // Argument counting its copies
+    struct CopyCounter {
+        static inline int copies = 0;
+
+        CopyCounter() = default;
+
+        CopyCounter(const CopyCounter&) {
+            ++copies;
+        }
+    };
+
+} // namespace
+
+// Emissions pass the arguments by reference to every slot
+TEST_CASE(emitDoesNotCopyArguments) {
+    Signal<CopyCounter> signal;
+    InlineSignal<CopyCounter> inline_signal;
+    int calls = 0;
+    for (int i = 0; i < 3; ++i) {
+        signal.connect([&](const CopyCounter&) { ++calls; });
+        inline_signal.connect([&](const CopyCounter&) { ++calls; });
+    }
+    const CopyCounter argument;
+    CopyCounter::copies = 0;
+    signal.emit(argument);
+    inline_signal.emit(argument);
+    CHECK(calls == 6);
+    CHECK(CopyCounter::copies == 0);
+}
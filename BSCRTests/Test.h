@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdio>
+#include <exception>
+#include <vector>
+
+namespace HKUltra::Testing {
+
+    /*
+    * Minimal test harness for the BSCR headers, without external dependencies.
+    * TEST_CASE(name) defines a test function and registers it; CHECK and CHECK_THROWS record a failure and let the
+    * test continue. runTests() runs every registered test, reports the failures and returns their number.
+    * An exception escaping a test counts as one failure of that test.
+    */
+    struct TestCase {
+        const char* name;  // Name of the test function
+        void (*function)();  // Test function
+    };
+
+    // Tests registered by TEST_CASE, in the order of their registration
+    inline std::vector<TestCase>& registeredTests() {
+        static std::vector<TestCase> tests;
+        return tests;
+    }
+
+    // Number of failed checks so far
+    inline int& failureCount() {
+        static int failures = 0;
+        return failures;
+    }
+
+    // Registers a test when a TEST_CASE is defined
+    struct TestRegistration {
+        TestRegistration(const char* name, void (*function)()) {
+            registeredTests().push_back(TestCase{ name, function });
+        }
+    };
+
+    // Records a failed check
+    inline void reportFailure(const char* expression, const char* file, int line) {
+        std::printf("  %s(%d): check failed: %s\n", file, line, expression);
+        ++failureCount();
+    }
+
+    // Runs all the registered tests. Returns the number of failures
+    inline int runTests() {
+        for (const TestCase& test : registeredTests()) {
+            const int failures = failureCount();
+            try {
+                test.function();
+            }
+            catch (const std::exception& exception) {
+                std::printf("  %s: unexpected exception: %s\n", test.name, exception.what());
+                ++failureCount();
+            }
+            catch (...) {
+                std::printf("  %s: unexpected exception\n", test.name);
+                ++failureCount();
+            }
+            std::printf("%s %s\n", failureCount() == failures ? "[ OK ]" : "[FAIL]", test.name);
+        }
+        std::printf("%zu tests, %d failures\n", registeredTests().size(), failureCount());
+        return failureCount();
+    }
+
+} // namespace HKUltra::Testing
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static const HKUltra::Testing::TestRegistration name##_registration(#name, &name); \
+    static void name()
+
+#define CHECK(expression) \
+    do { \
+        if (!(expression)) { \
+            HKUltra::Testing::reportFailure(#expression, __FILE__, __LINE__); \
+        } \
+    } while (false)
+
+#define CHECK_THROWS(expression, exception_type) \
+    do { \
+        bool thrown = false; \
+        try { \
+            (void)(expression); \
+        } \
+        catch (const exception_type&) { \
+            thrown = true; \
+        } \
+        if (!thrown) { \
+            HKUltra::Testing::reportFailure(#expression " throws " #exception_type, __FILE__, __LINE__); \
+        } \
+    } while (false)
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "Date.h"
+#include "DateVector.h"
+#include "Test.h"
+#include "TimeSeries.h"
+
+using namespace HKUltra;
+
+namespace {
+
+    // Series of `size` values on every third day from 2024-01-01, the value of each date being its index
+    TimeSeries<int> everyThirdDay(std::size_t size) {
+        DateVector dates;
+        std::vector<int> values;
+        for (std::size_t i = size; i-- > 0;) {  // In reverse order, which the constructor sorts
+            dates.pushBack("2024-01-01"_date + Days(3 * i));
+            values.push_back(int(i));
+        }
+        return TimeSeries<int>(dates, values);
+    }
+
+} // namespace
+
+// Branch-free searches in the Eytzinger index agree with a binary search of the sorted dates, for any tree shape
+TEST_CASE(timeSeriesSearches) {
+    bool matches = true;
+    for (std::size_t size = 0; size < 70; ++size) {
+        const TimeSeries<int> series = everyThirdDay(size);
+        for (Date date = "2023-12-30"_date; date < "2024-01-01"_date + Days(3 * size + 3); date += Days(1)) {
+            const std::span<const Date::SerialType> serial_numbers = series.serialNumbers();
+            const std::size_t expected = std::size_t(std::lower_bound(serial_numbers.begin(), serial_numbers.end(), date.serialNumber()) - serial_numbers.begin());
+            const int* exact = series.find(date);
+            const int* as_of = series.asOf(date);
+            const std::int32_t offset = date.serialNumber() - "2024-01-01"_date.serialNumber();
+            matches = matches && series.lowerBound(date) == expected
+                && (offset % 3 == 0 && expected < size ? exact && *exact == offset / 3 : !exact)
+                && (offset < 0 || size == 0 ? !as_of : as_of && *as_of == std::min(offset / 3, int(size) - 1));
+        }
+    }
+    CHECK(matches);
+}
+
+// Values are set in date order; ranges are views of both arrays
+TEST_CASE(timeSeriesUpdatesAndRanges) {
+    TimeSeries<int> series = everyThirdDay(10);
+    series.set("2024-01-04"_date, 100);
+    series.set("2024-01-05"_date, 200);
+    CHECK(series.size() == 11 && *series.find("2024-01-04"_date) == 100 && *series.asOf("2024-01-06"_date) == 200);
+    CHECK(series.date(2) == "2024-01-05"_date && series.value(2) == 200);
+
+    const TimeSeries<int>::Range range = series.range("2024-01-04"_date, "2024-01-10"_date);
+    CHECK(range.serial_numbers.size() == 3 && range.values.size() == 3);
+    CHECK(range.values[0] == 100 && range.values[1] == 200 && range.values[2] == 2);
+    CHECK(series.range("2025-01-01"_date, "2025-02-01"_date).values.empty());
+
+    DateVector duplicates(2, "2024-01-01"_date);
+    const std::vector<int> values = { 1, 2 };
+    CHECK_THROWS(TimeSeries<int>(duplicates, values), std::invalid_argument);
+    CHECK_THROWS(TimeSeries<int>(duplicates, std::span(values).first(1)), std::invalid_argument);
+}
+
+// Bulk joins of sorted (merge join) and unsorted dates give the values of find and asOf
+TEST_CASE(timeSeriesJoins) {
+    const TimeSeries<int> series = everyThirdDay(40);
+    DateVector sorted;
+    for (Date date = "2023-12-25"_date; date < "2024-05-01"_date; date += Days(2)) {
+        sorted.pushBack(date);
+    }
+    DateVector unsorted = sorted;
+    std::reverse(unsorted.serialNumbers().begin(), unsorted.serialNumbers().end());
+
+    for (const DateVector* dates : { &sorted, &unsorted }) {
+        std::vector<int> exact(dates->size());
+        std::vector<int> as_of(dates->size());
+        series.joinExact(*dates, exact, -1);
+        series.joinAsOf(*dates, as_of, -1);
+        bool matches = true;
+        for (std::size_t i = 0; i < dates->size(); ++i) {
+            const int* found = series.find((*dates)[i]);
+            const int* last = series.asOf((*dates)[i]);
+            matches = matches && exact[i] == (found ? *found : -1) && as_of[i] == (last ? *last : -1);
+        }
+        CHECK(matches);
+    }
+    std::vector<int> small(sorted.size() - 1);
+    CHECK_THROWS(series.joinExact(sorted, small, -1), std::invalid_argument);
+}
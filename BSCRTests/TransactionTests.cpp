@@ -0,0 +1,148 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Computed.h"
+#include "ObservableValue.h"
+#include "Test.h"
+#include "Transaction.h"
+
+using namespace HKUltra;
+
+namespace {
+
+    // Observer of int and string values, checking on each notification what the commit changed
+    struct MixedObserver : Observer<int, ValueVersion>, Observer<std::string, ValueVersion> {
+        const ObservableValue<int>& first;
+        const ObservableValue<int>& second;
+        std::vector<std::string> notifications;
+
+        MixedObserver(const ObservableValue<int>& lhs, const ObservableValue<int>& rhs) : first(lhs), second(rhs) {}
+
+        void onNotify(const int& value, const ValueVersion&) override {
+            const Transaction* transaction = Transaction::committing();
+            notifications.push_back(std::to_string(value) + (transaction && transaction->changed(first) ? " first" : "")
+                + (transaction && transaction->changed(second) ? " second" : "") + " " + std::to_string(first.get() + second.get()));
+        }
+
+        void onNotify(const std::string& value, const ValueVersion&) override {
+            notifications.push_back(value);
+        }
+    };
+
+    // Observer counting its notifications
+    struct CountingObserver : Observer<int, ValueVersion> {
+        int calls = 0;
+
+        void onNotify(const int&, const ValueVersion&) override {
+            ++calls;
+        }
+    };
+
+} // namespace
+
+// Values set in a transaction are stored on commit; an observer is notified once per observer type
+TEST_CASE(transactionNotifiesEachObserverOnce) {
+    ObservableValue<int> first(1);
+    ObservableValue<int> second(2);
+    ObservableValue<std::string> text("a");
+    MixedObserver observer(first, second);
+    observer.Observer<int, ValueVersion>::registerWith(first);
+    observer.Observer<int, ValueVersion>::registerWith(second);
+    observer.Observer<std::string, ValueVersion>::registerWith(text);
+
+    Transaction transaction;
+    second.set(20);
+    first.set(9);
+    first.set(10);  // Keeps the last value
+    text.set("b");
+    CHECK(first.get() == 1 && second.get() == 2 && observer.notifications.empty());
+    CHECK(Transaction::current() == &transaction && !Transaction::committing());
+    transaction.commit();
+    // Notified with the first value set, seeing both changes and both new values
+    CHECK(observer.notifications == std::vector<std::string>({ "20 first second 30", "b" }));
+    CHECK(transaction.changedValues().size() == 3 && transaction.changedValues()[0] == &second);
+    CHECK(!Transaction::current() && !Transaction::committing());
+}
+
+// Unchanged values are not notified, nested transactions join, and uncommitted values are discarded
+TEST_CASE(transactionScopes) {
+    ObservableValue<int> value(1);
+    ObservableValue<int> unchanged(5);
+    CountingObserver observer;
+    observer.registerWith(value);
+    observer.registerWith(unchanged);
+    {
+        Transaction transaction;
+        value.set(2);
+        {
+            Transaction nested;
+            unchanged.set(5);
+            nested.commit();  // Joined: commits nothing
+            CHECK(value.get() == 1);
+        }
+        transaction.commit();
+        CHECK(!transaction.changed(unchanged) && transaction.changed(value));
+    }
+    CHECK(value.get() == 2 && observer.calls == 1);
+    {
+        Transaction transaction;
+        value.set(3);
+    }
+    CHECK(value.get() == 2 && observer.calls == 1);
+}
+
+// Read-modify-write operations throw, and Computed values are refreshed once per commit
+TEST_CASE(transactionRefreshesComputedOnce) {
+    ObservableValue<int> lhs(1);
+    ObservableValue<int> rhs(2);
+    Computed<int> sum([](int a, int b) { return a + b; }, lhs, rhs);
+    CountingObserver observer;
+    observer.registerWith(sum);
+    {
+        Transaction transaction;
+        lhs.set(10);
+        rhs.set(20);
+        CHECK_THROWS(lhs.update([](int value) { return value + 1; }), std::logic_error);
+        CHECK_THROWS(rhs.compareAndSet(2, 3), std::logic_error);
+        transaction.commit();
+    }
+    CHECK(observer.calls == 1 && sum.get() == 30);
+}
+
+// Values destroyed while buffered, or while the commit notifies, are dropped from the transaction
+TEST_CASE(transactionDropsDestroyedValues) {
+    ObservableValue<int> kept(0);
+    CountingObserver observer;
+    observer.registerWith(kept);
+    {
+        Transaction transaction;
+        {
+            ObservableValue<int> temporary(0);
+            temporary.set(1);
+            kept.set(1);
+        }
+        transaction.commit();  // Must not store into the destroyed value
+        CHECK(transaction.changedValues().size() == 1);
+    }
+    CHECK(kept.get() == 1 && observer.calls == 1);
+
+    auto destroyed = std::make_unique<ObservableValue<int>>(0);
+    CountingObserver late;
+    late.registerWith(*destroyed);
+    struct Destroyer : Observer<int, ValueVersion> {
+        std::unique_ptr<ObservableValue<int>>* value = nullptr;
+
+        void onNotify(const int&, const ValueVersion&) override {
+            value->reset();
+        }
+    } destroyer;
+    destroyer.value = &destroyed;
+    destroyer.registerWith(kept);
+    Transaction transaction;
+    kept.set(2);
+    destroyed->set(2);
+    transaction.commit();  // The first notification destroys the second value before it is notified
+    CHECK(!destroyed && late.calls == 0);
+    CHECK(transaction.changedValues().size() == 1 && transaction.changed(kept));
+}
@@ -0,0 +1,64 @@
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include "Date.h"
+#include "LockPolicy.h"
+#include "ObservableValue.h"
+#include "Test.h"
+#include "ValueStorage.h"
+
+using namespace HKUltra;
+
+namespace {
+
+    // Value spanning several words, so a torn read would mix the words of two values
+    struct Triple {
+        std::uint64_t a = 0;
+        std::uint64_t b = 0;
+        std::uint64_t c = 0;
+
+        bool operator!=(const Triple& rhs) const {
+            return a != rhs.a || b != rhs.b || c != rhs.c;
+        }
+    };
+
+} // namespace
+
+static_assert(is_seqlock_storage_v<Date, std::mutex> && is_seqlock_storage_v<Triple, SpinLock>);
+static_assert(!is_seqlock_storage_v<std::string, std::mutex> && !is_seqlock_storage_v<Date, NullLock>);
+static_assert(std::is_same_v<ObservableValue<Date, SharedLock>::StorageType, SeqLockValue<Date, SharedLock>>);
+
+// Writes count versions, and unchanged values keep theirs
+TEST_CASE(storageVersions) {
+    SeqLockValue<Triple, std::mutex> seqlock(Triple{ 1, 1, 1 });
+    LockedValue<std::string, std::mutex> locked("a");
+    CHECK(seqlock.version() == 1 && locked.version() == 1);
+    CHECK(seqlock.store(Triple{ 1, 1, 1 }) == 0 && locked.store("a") == 0);
+    CHECK(seqlock.store(Triple{ 2, 2, 2 }) == 2 && locked.store("b") == 2);
+    const Versioned<Triple> read = seqlock.loadVersioned();
+    CHECK(read.value.c == 2 && read.version == 2);
+    CHECK(locked.loadVersioned().value == "b");
+}
+
+// Lock-free readers never see a partially written value, and versions match the values they are read with
+TEST_CASE(seqlockReadsAreConsistent) {
+    ObservableValue<Triple, SpinLock> value(Triple{});
+    std::thread writer([&] {
+        for (std::uint64_t i = 1; i <= 20000; ++i) {
+            value.set(Triple{ i, i, i });
+        }
+        });
+    bool consistent = true;
+    ValueVersion last = 0;
+    while (last < 20001) {
+        const Versioned<Triple> read = value.getVersioned();
+        consistent = consistent && read.value.a == read.value.b && read.value.b == read.value.c
+            && read.version == read.value.a + 1 && read.version >= last;
+        last = read.version;
+    }
+    writer.join();
+    CHECK(consistent);
+    CHECK(value.version() == 20001);
+}